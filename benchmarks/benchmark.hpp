@@ -0,0 +1,311 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_BENCHMARK_HPP
+#define CASADI_BENCHMARK_HPP
+
+#include <casadi/casadi.hpp>
+#include <casadi/config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+/** \brief Minimal harness shared by the C++ benchmarks
+
+    Each benchmark executable creates a Benchmark instance from its command line
+    arguments, registers timed kernels with run() or externally measured results
+    with record(), and returns finish(). The results are written as JSON, to be
+    compared between builds with compare.py.
+
+    Command line arguments:
+      --output=FILE    Write the JSON results to FILE instead of stdout
+      --filter=STR     Only run benchmarks whose name contains STR
+      --min-time=T     Minimum accumulated time per benchmark, in seconds (0.2)
+      --quick          Only run the smallest problem sizes
+      --list           List the benchmarks instead of running them
+*/
+namespace benchmark {
+  using namespace casadi;
+
+  /// Wall clock time in seconds
+  inline double wtime() {
+    return std::chrono::duration<double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /// Write a GenericType as JSON
+  inline void to_json(std::ostream& s, const GenericType& v) {
+    if (v.is_dict()) {
+      s << "{";
+      bool first = true;
+      for (auto&& e : v.as_dict()) {
+        if (!first) s << ", ";
+        first = false;
+        s << "\"" << e.first << "\": ";
+        to_json(s, e.second);
+      }
+      s << "}";
+    } else if (v.is_bool()) {
+      s << (v.as_bool() ? "true" : "false");
+    } else if (v.is_int()) {
+      s << v.as_int();
+    } else if (v.is_double()) {
+      double d = v.as_double();
+      if (std::isfinite(d)) {
+        s << std::setprecision(9) << d;
+      } else {
+        s << "null";
+      }
+    } else if (v.is_string()) {
+      s << "\"" << v.as_string() << "\"";
+    } else if (v.is_int_vector() || v.is_double_vector()) {
+      std::vector<double> d = v.to_double_vector();
+      s << "[";
+      for (casadi_int k=0; k<d.size(); ++k) {
+        if (k>0) s << ", ";
+        to_json(s, d[k]);
+      }
+      s << "]";
+    } else if (v.is_string_vector()) {
+      std::vector<std::string> d = v.as_string_vector();
+      s << "[";
+      for (casadi_int k=0; k<d.size(); ++k) s << (k>0 ? ", \"" : "\"") << d[k] << "\"";
+      s << "]";
+    } else {
+      s << "null";
+    }
+  }
+
+  /** \brief Numerical evaluation of a Function with preallocated buffers
+
+      Inputs are filled with reproducible values in [0.1, 1]
+  */
+  class FunctionEval {
+  public:
+    explicit FunctionEval(const Function& f) : f_(f), fb_(f) {
+      std::mt19937 gen(1);
+      std::uniform_real_distribution<double> dist(0.1, 1);
+      arg_.resize(f.n_in());
+      for (casadi_int i=0; i<f.n_in(); ++i) {
+        arg_[i].resize(f.nnz_in(i));
+        for (double& e : arg_[i]) e = dist(gen);
+        fb_.set_arg(i, get_ptr(arg_[i]), arg_[i].size()*sizeof(double));
+      }
+      res_.resize(f.n_out());
+      for (casadi_int i=0; i<f.n_out(); ++i) {
+        res_[i].resize(f.nnz_out(i));
+        fb_.set_res(i, get_ptr(res_[i]), res_[i].size()*sizeof(double));
+      }
+    }
+
+    /// Set an input, by index
+    void set(casadi_int i, const std::vector<double>& v) {
+      casadi_assert(v.size()==arg_.at(i).size(), "Dimension mismatch");
+      std::copy(v.begin(), v.end(), arg_[i].begin());
+    }
+
+    /// Set an input, by name
+    void set(const std::string& name, const std::vector<double>& v) {
+      set(f_.index_in(name), v);
+    }
+
+    /// Get an output, by index
+    const std::vector<double>& get(casadi_int i) const { return res_.at(i);}
+
+    /// Evaluate
+    void operator()() {
+      fb_._eval();
+      casadi_assert(fb_.ret()==0, "Evaluation of " + f_.name() + " failed");
+    }
+
+  private:
+    Function f_;
+    FunctionBuffer fb_;
+    std::vector<std::vector<double> > arg_, res_;
+  };
+
+  /// Merge two dictionaries, giving priority to the second one
+  inline Dict merge(const Dict& first, const Dict& second) {
+    Dict ret = first;
+    for (auto&& e : second) ret[e.first] = e.second;
+    return ret;
+  }
+
+  /// Random sparsity pattern with about nz_per_col nonzeros per column and a full diagonal
+  inline Sparsity random_sparsity(casadi_int n, casadi_int nz_per_col, unsigned seed=1) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<casadi_int> dist(0, n-1);
+    std::vector<casadi_int> row, col;
+    for (casadi_int c=0; c<n; ++c) {
+      row.push_back(c);
+      col.push_back(c);
+      for (casadi_int k=1; k<nz_per_col; ++k) {
+        row.push_back(dist(gen));
+        col.push_back(c);
+      }
+    }
+    return Sparsity::triplet(n, n, row, col);
+  }
+
+  /// Timing harness and result collection
+  class Benchmark {
+  public:
+    Benchmark(const std::string& suite, int argc, char* argv[])
+      : suite_(suite), min_time_(0.2), quick_(false), list_(false) {
+      for (int i=1; i<argc; ++i) {
+        std::string a = argv[i];
+        if (a.find("--output=")==0) {
+          output_ = a.substr(9);
+        } else if (a.find("--filter=")==0) {
+          filter_ = a.substr(9);
+        } else if (a.find("--min-time=")==0) {
+          min_time_ = std::stod(a.substr(11));
+        } else if (a=="--quick") {
+          quick_ = true;
+        } else if (a=="--list") {
+          list_ = true;
+        } else {
+          casadi_error("Unknown argument '" + a + "'. Valid arguments: "
+            "--output=FILE, --filter=STR, --min-time=T, --quick, --list");
+        }
+      }
+    }
+
+    /// Only run the smallest problems?
+    bool quick() const { return quick_;}
+
+    /// Problem sizes to be run, only the smallest in quick mode
+    std::vector<casadi_int> sizes(const std::vector<casadi_int>& all) const {
+      if (quick_ && !all.empty()) return {all.front()};
+      return all;
+    }
+
+    /// Should a benchmark be run?
+    bool active(const std::string& name) const {
+      if (name.find(filter_)==std::string::npos) return false;
+      if (list_) {
+        std::cerr << name << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    /** \brief Time a kernel
+
+        The kernel is called once to warm up, then repeatedly in batches until
+        the accumulated time exceeds min_time. The minimum, median and mean time
+        per call over the batches are reported. Returns false if the benchmark
+        was filtered out.
+    */
+    bool run(const std::string& name, const Dict& params,
+             const std::function<void()>& fcn, const Dict& extra=Dict()) {
+      if (!active(name)) return false;
+      // Warm-up, also gives the batch size
+      double t0 = wtime();
+      fcn();
+      double t1 = std::max(wtime() - t0, 1e-9);
+      const casadi_int n_batch = 10;
+      casadi_int batch = std::max(static_cast<casadi_int>(min_time_/n_batch/t1), casadi_int(1));
+      std::vector<double> t;
+      double t_tot = 0;
+      while (t.size()<3 || t_tot<min_time_) {
+        t0 = wtime();
+        for (casadi_int k=0; k<batch; ++k) fcn();
+        double tb = wtime() - t0;
+        t_tot += tb;
+        t.push_back(tb/static_cast<double>(batch));
+        if (t.size()>=100) break;
+      }
+      std::sort(t.begin(), t.end());
+      double mean = 0;
+      for (double e : t) mean += e;
+      mean /= static_cast<double>(t.size());
+      Dict r = extra;
+      r["time"] = Dict{{"min", t.front()}, {"median", t[t.size()/2]}, {"mean", mean},
+                       {"calls", static_cast<casadi_int>(t.size())*batch}};
+      add(name, params, r);
+      return true;
+    }
+
+    /// Add entries to the last result
+    void annotate(const Dict& extra) {
+      casadi_assert(!results_.empty(), "No result to annotate");
+      for (auto&& e : extra) results_.back()[e.first] = e.second;
+    }
+
+    /// Record a result measured elsewhere, should contain an entry "time"
+    void record(const std::string& name, const Dict& params, const Dict& r) {
+      if (!active(name)) return;
+      add(name, params, r);
+    }
+
+    /// Write results, returns the exit code
+    int finish() {
+      if (list_) return 0;
+      std::ofstream file;
+      if (!output_.empty()) file.open(output_);
+      std::ostream& s = output_.empty() ? std::cout : file;
+      s << "{\"suite\": \"" << suite_ << "\", \"version\": \"" << CASADI_VERSION_STRING
+        << "\", \"results\": [";
+      for (casadi_int k=0; k<results_.size(); ++k) {
+        s << (k==0 ? "\n  " : ",\n  ");
+        to_json(s, results_[k]);
+      }
+      s << "\n]}" << std::endl;
+      return 0;
+    }
+
+  private:
+    // Add a result and print progress
+    void add(const std::string& name, const Dict& params, const Dict& r) {
+      Dict e = r;
+      e["name"] = name;
+      e["params"] = params;
+      results_.push_back(e);
+      std::cerr << std::left << std::setw(32) << name << " " << std::setw(28) << str(params);
+      auto it = r.find("time");
+      if (it!=r.end()) {
+        const GenericType& t = it->second;
+        std::cerr << " " << (t.is_dict() ? t.as_dict().at("median") : t) << " s";
+      }
+      std::cerr << std::endl;
+    }
+
+    std::string suite_, output_, filter_;
+    double min_time_;
+    bool quick_, list_;
+    std::vector<Dict> results_;
+  };
+
+} // namespace benchmark
+
+#endif // CASADI_BENCHMARK_HPP
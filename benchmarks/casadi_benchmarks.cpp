@@ -0,0 +1,178 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Microbenchmarks of the core numerical kernels
+
+    Function evaluation (SX and MX, nominal and derivatives), sparsity pattern
+    operations, the native linear solvers, qrqp and the interpolants, for a
+    range of problem sizes.
+*/
+
+#include "benchmark.hpp"
+
+using namespace casadi;
+using namespace benchmark;
+
+// Vector-valued test expression with some coupling between the elements
+template<typename M>
+M test_expression(const M& x, casadi_int n_layer) {
+  casadi_int n = x.size1();
+  M y = x;
+  for (casadi_int k=0; k<n_layer; ++k) {
+    M y_shift = vertcat(y(Slice(1, n)), y(0));
+    y = sin(y)*y_shift + exp(-y)*0.5;
+  }
+  return y;
+}
+
+void function_benchmarks(Benchmark& b) {
+  for (casadi_int n : b.sizes({10, 100, 1000})) {
+    Dict p = {{"n", n}};
+
+    // Scalar expression graph
+    SX x = SX::sym("x", n);
+    Function f_sx("f_sx", {x}, {test_expression(x, 10)});
+
+    // Matrix expression graph: sparse matrix-vector products and elementwise operations
+    MX y = MX::sym("y", n);
+    DM A = DM::ones(Sparsity::banded(n, 2))*0.1 + DM::eye(n);
+    MX z = y;
+    for (casadi_int k=0; k<10; ++k) z = mtimes(A, sin(z)) + y;
+    Function f_mx("f_mx", {y}, {z});
+
+    for (auto&& f : {f_sx, f_mx}) {
+      std::string prefix = f.is_a("SXFunction") ? "sx" : "mx";
+      FunctionEval f_eval(f);
+      b.run(prefix + "_eval", p, [&]() { f_eval();});
+      FunctionEval fwd_eval(f.forward(1));
+      b.run(prefix + "_forward", p, [&]() { fwd_eval();});
+      FunctionEval adj_eval(f.reverse(1));
+      b.run(prefix + "_reverse", p, [&]() { adj_eval();});
+      FunctionEval jac_eval(f.jacobian());
+      b.run(prefix + "_jacobian", p, [&]() { jac_eval();});
+    }
+  }
+}
+
+void sparsity_benchmarks(Benchmark& b) {
+  for (casadi_int n : b.sizes({100, 1000, 10000})) {
+    Dict p = {{"n", n}};
+    Sparsity sp1 = random_sparsity(n, 5, 1);
+    Sparsity sp2 = random_sparsity(n, 5, 2);
+    Sparsity sp_sym = sp1 + sp1.T();
+
+    b.run("sparsity_unite", p, [&]() { sp1.unite(sp2);});
+    b.run("sparsity_intersect", p, [&]() { sp1.intersect(sp2);});
+    b.run("sparsity_mtimes", p, [&]() { Sparsity::mtimes(sp1, sp2);});
+    b.run("sparsity_uni_coloring", p, [&]() { sp1.uni_coloring();});
+    b.run("sparsity_star_coloring", p, [&]() { sp_sym.star_coloring();});
+    b.run("sparsity_amd", p, [&]() { sp_sym.amd();});
+
+    // The block triangular form is cached, so the pattern is created anew
+    std::vector<casadi_int> colind = sp1.get_colind(), row = sp1.get_row();
+    b.run("sparsity_btf", p, [&]() {
+      std::vector<casadi_int> rowperm, colperm, rowblock, colblock, crowblock, ccolblock;
+      Sparsity(n, n, colind, row).btf(rowperm, colperm, rowblock, colblock, crowblock, ccolblock);
+    });
+  }
+}
+
+void linsol_benchmarks(Benchmark& b) {
+  for (casadi_int n : b.sizes({10, 100, 1000})) {
+    // Symmetric, diagonally dominant matrix with some fill-in
+    Sparsity sp = random_sparsity(n, 3, 1);
+    sp = sp + sp.T();
+    DM A = DM::ones(sp) + n*DM::eye(n);
+    std::vector<double> rhs(n, 1.), x(n);
+    for (std::string solver : {"qr", "ldl"}) {
+      Dict p = {{"n", n}, {"solver", solver}};
+      Linsol ls("ls", solver, sp);
+      ls.sfact(A.ptr());
+      b.run("linsol_nfact", p, [&]() { ls.nfact(A.ptr());});
+      b.run("linsol_solve", p, [&]() {
+        std::copy(rhs.begin(), rhs.end(), x.begin());
+        ls.solve(A.ptr(), get_ptr(x));
+      });
+    }
+  }
+}
+
+void conic_benchmarks(Benchmark& b) {
+  for (casadi_int n : b.sizes({10, 50, 100})) {
+    Dict p = {{"n", n}};
+    // Strictly convex QP with n/2 linear constraints
+    casadi_int m = n/2;
+    Sparsity sp_h = Sparsity::banded(n, 1);
+    DM H = DM::ones(sp_h)*0.1 + 2*DM::eye(n);
+    DM A = DM::ones(random_sparsity(n, 2, 3))(Slice(0, m), Slice());
+    Function qp = conic("qp", "qrqp", {{"h", H.sparsity()}, {"a", A.sparsity()}},
+      {{"print_iter", false}, {"print_header", false}});
+    FunctionEval qp_eval(qp);
+    qp_eval.set("h", H.nonzeros());
+    qp_eval.set("a", A.nonzeros());
+    qp_eval.set("lbx", std::vector<double>(n, -1));
+    qp_eval.set("ubx", std::vector<double>(n, 1));
+    qp_eval.set("lba", std::vector<double>(m, -0.5));
+    qp_eval.set("uba", std::vector<double>(m, 0.5));
+    b.run("qrqp_solve", p, [&]() { qp_eval();});
+  }
+}
+
+void interpolant_benchmarks(Benchmark& b) {
+  for (casadi_int n : b.sizes({10, 100})) {
+    for (casadi_int ndim : {1, 2, 3}) {
+      // Limit the number of grid points
+      if (std::pow(n, ndim)>1e5) continue;
+      std::vector<std::vector<double> > grid(ndim);
+      casadi_int ngrid = 1;
+      for (auto&& g : grid) {
+        for (casadi_int k=0; k<n; ++k) g.push_back(static_cast<double>(k));
+        ngrid *= n;
+      }
+      std::vector<double> values(ngrid);
+      for (casadi_int k=0; k<ngrid; ++k) values[k] = sin(0.1*static_cast<double>(k));
+      for (std::string solver : {"linear", "bspline"}) {
+        Dict p = {{"n", n}, {"ndim", ndim}, {"solver", solver}};
+        Function f = interpolant("f", solver, grid, values);
+        FunctionEval f_eval(f);
+        f_eval.set(0, std::vector<double>(ndim, 0.37*static_cast<double>(n)));
+        b.run("interpolant_eval", p, [&]() { f_eval();});
+        FunctionEval jac_eval(f.jacobian());
+        jac_eval.set(0, std::vector<double>(ndim, 0.37*static_cast<double>(n)));
+        b.run("interpolant_jacobian", p, [&]() { jac_eval();});
+      }
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Benchmark b("casadi_benchmarks", argc, argv);
+  function_benchmarks(b);
+  sparsity_benchmarks(b);
+  linsol_benchmarks(b);
+  conic_benchmarks(b);
+  interpolant_benchmarks(b);
+  return b.finish();
+}
@@ -0,0 +1,196 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Complexity regression tests for symbolic construction
+
+    The C++ counterpart of test/python/complexity.py. For each operation, the
+    construction time and the memory footprint of the result are measured for
+    growing problem sizes, until the construction time exceeds a limit. The
+    complexity exponents are estimated with a least-squares fit in log-log
+    scale. The program exits with status 1 if an exponent exceeds its
+    threshold.
+*/
+
+#include "benchmark.hpp"
+
+using namespace casadi;
+using namespace benchmark;
+
+/** \brief Construction test
+
+    Given a size, the kernel performs any setup, times the operation and
+    returns the elapsed time together with the result, wrapped in a Function
+    for the memory measurement.
+*/
+struct ComplexityCase {
+  std::string name;
+  double max_order;
+  std::function<double(casadi_int n, Function& res)> kernel;
+};
+
+// Time an operation and wrap its result in a Function
+template<typename M>
+double timed(const std::vector<M>& in, const std::function<M()>& op, Function& res) {
+  double t0 = wtime();
+  M r = op();
+  double t = wtime() - t0;
+  res = Function("res", in, {r});
+  return t;
+}
+
+// Sum of coupled nonlinear terms, with a sparse Jacobian and Hessian
+template<typename M>
+M coupled(const M& x) {
+  casadi_int n = x.size1();
+  M x_shift = vertcat(x(Slice(1, n)), x(0));
+  return sin(x*x_shift) + x*x;
+}
+
+std::vector<ComplexityCase> cases() {
+  std::vector<ComplexityCase> c;
+  // SX operations
+  c.push_back({"sx_function", 1.3, [](casadi_int n, Function& res) {
+    SX x = SX::sym("x", n);
+    SX y = coupled(x);
+    double t0 = wtime();
+    res = Function("f", {x}, {y});
+    return wtime() - t0;
+  }});
+  c.push_back({"sx_jacobian", 1.3, [](casadi_int n, Function& res) {
+    SX x = SX::sym("x", n);
+    SX y = coupled(x);
+    return timed<SX>({x}, [&]() { return jacobian(y, x);}, res);
+  }});
+  c.push_back({"sx_hessian", 1.3, [](casadi_int n, Function& res) {
+    SX x = SX::sym("x", n);
+    SX y = sum1(coupled(x));
+    return timed<SX>({x}, [&]() { return hessian(y, x);}, res);
+  }});
+  c.push_back({"sx_substitute", 1.3, [](casadi_int n, Function& res) {
+    SX x = SX::sym("x", n), v = SX::sym("v", n);
+    SX y = coupled(x);
+    return timed<SX>({v}, [&]() { return substitute(y, x, 2*v);}, res);
+  }});
+  c.push_back({"sx_vertcat", 1.3, [](casadi_int n, Function& res) {
+    SX x = SX::sym("x", n);
+    std::vector<SX> v = vertsplit(x);
+    return timed<SX>({x}, [&]() { return vertcat(v);}, res);
+  }});
+  // MX operations
+  c.push_back({"mx_function", 1.3, [](casadi_int n, Function& res) {
+    MX x = MX::sym("x", n);
+    std::vector<MX> xk = vertsplit(x);
+    MX y = 0;
+    for (auto&& e : xk) y += sin(e)*e;
+    double t0 = wtime();
+    res = Function("f", {x}, {y});
+    return wtime() - t0;
+  }});
+  c.push_back({"mx_jacobian", 1.3, [](casadi_int n, Function& res) {
+    MX x = MX::sym("x", n);
+    MX y = coupled(x);
+    return timed<MX>({x}, [&]() { return jacobian(y, x);}, res);
+  }});
+  c.push_back({"mx_vertcat", 1.3, [](casadi_int n, Function& res) {
+    MX x = MX::sym("x", n);
+    std::vector<MX> v = vertsplit(x);
+    for (auto&& e : v) e = sin(e);
+    return timed<MX>({x}, [&]() { return vertcat(v);}, res);
+  }});
+  c.push_back({"mx_vertsplit", 1.3, [](casadi_int n, Function& res) {
+    MX x = MX::sym("x", n);
+    MX y = sin(x);
+    return timed<MX>({x}, [&]() { return sum1(vertcat(vertsplit(y)));}, res);
+  }});
+  c.push_back({"mx_substitute", 1.3, [](casadi_int n, Function& res) {
+    MX x = MX::sym("x", n), v = MX::sym("v", n);
+    std::vector<MX> xk = vertsplit(x);
+    MX y = 0;
+    for (auto&& e : xk) y += sin(e)*e;
+    return timed<MX>({v}, [&]() { return substitute(y, x, 2*v);}, res);
+  }});
+  c.push_back({"mx_expand", 1.3, [](casadi_int n, Function& res) {
+    MX x = MX::sym("x", n);
+    Function f("f", {x}, {coupled(x)});
+    double t0 = wtime();
+    res = f.expand();
+    return wtime() - t0;
+  }});
+  return c;
+}
+
+// Least-squares slope in log-log scale
+double fit_order(const std::vector<double>& n, const std::vector<double>& y) {
+  casadi_int m = n.size();
+  double sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (casadi_int k=0; k<m; ++k) {
+    double lx = log(n[k]), ly = log(y[k]);
+    sx += lx;
+    sy += ly;
+    sxx += lx*lx;
+    sxy += lx*ly;
+  }
+  return (m*sxy - sx*sy)/(m*sxx - sx*sx);
+}
+
+int main(int argc, char* argv[]) {
+  Benchmark b("casadi_complexity", argc, argv);
+  // Times below mint are not trusted, stop growing when maxt is exceeded
+  double mint = 0.01, maxt = b.quick() ? 0.05 : 0.5;
+  casadi_int n_fail = 0;
+  for (auto&& c : cases()) {
+    if (!b.active(c.name)) continue;
+    std::vector<double> sizes, times, mem;
+    for (casadi_int n=16; n<=1<<20; n*=2) {
+      // Best of three for short times
+      Function res;
+      double t = c.kernel(n, res);
+      for (casadi_int r=0; r<2 && t<10*mint; ++r) t = std::min(t, c.kernel(n, res));
+      if (t>=mint) {
+        sizes.push_back(static_cast<double>(n));
+        times.push_back(t);
+        mem.push_back(static_cast<double>(res.memory_footprint().at("total").as_int()));
+      }
+      if (t>maxt) break;
+    }
+    Dict r = {{"sizes", sizes}, {"times", times}, {"memory", mem}, {"max_order", c.max_order}};
+    if (sizes.size()>=3) {
+      double order = fit_order(sizes, times), mem_order = fit_order(sizes, mem);
+      r["order"] = order;
+      r["memory_order"] = mem_order;
+      r["time"] = times.back();
+      if (order>c.max_order || mem_order>c.max_order) {
+        n_fail++;
+        std::cerr << c.name << ": complexity exponent " << order << " (time), "
+                  << mem_order << " (memory) exceeds " << c.max_order << std::endl;
+      }
+    } else {
+      std::cerr << c.name << ": too few reliable measurements" << std::endl;
+    }
+    b.record(c.name, Dict(), r);
+  }
+  int flag = b.finish();
+  return n_fail>0 ? 1 : flag;
+}
@@ -0,0 +1,231 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Integrator benchmarks on stiff and non-stiff reference problems
+
+    Every available integrator plugin is run on each test problem for a range
+    of accuracy settings (tolerances for the variable step methods, number of
+    finite elements for the fixed step methods). For each setting, the time of
+    an integration, of a forward and of an adjoint sensitivity evaluation are
+    reported, together with the error in the final state with respect to a
+    tight-tolerance reference solution (work-precision data), the memory
+    objects allocated, as counted by PerfCounters, and the memory footprint.
+*/
+
+#include "benchmark.hpp"
+
+using namespace casadi;
+using namespace benchmark;
+
+/// Test problem: an ODE with parameters
+struct OdeProblem {
+  SXDict dae;
+  double tf;
+  std::vector<double> x0, p;
+};
+
+// Robertson chemical kinetics, stiff
+OdeProblem robertson() {
+  SX x = SX::sym("x", 3), p = SX::sym("p", 3);
+  SX r1 = p(0)*x(0), r2 = p(1)*x(1)*x(2), r3 = p(2)*x(1)*x(1);
+  return {{{"x", x}, {"p", p}, {"ode", vertcat(-r1 + r2, r1 - r2 - r3, r3)}},
+          40, {1, 0, 0}, {0.04, 1e4, 3e7}};
+}
+
+// Van der Pol oscillator, stiff for large mu
+OdeProblem van_der_pol(double mu) {
+  SX x = SX::sym("x", 2), p = SX::sym("p");
+  return {{{"x", x}, {"p", p}, {"ode", vertcat(x(1), p*(1 - x(0)*x(0))*x(1) - x(0))}},
+          2, {2, 0}, {mu}};
+}
+
+// HIRES, photomorphogenesis, stiff, parameters scale the rate constants
+OdeProblem hires() {
+  SX y = SX::sym("y", 8), p = SX::sym("p", 2);
+  SX k = p(0), l = p(1);
+  SX f = vertcat(std::vector<SX>{
+    -1.71*y(0) + 0.43*y(1) + 8.32*y(2) + 0.0007,
+    1.71*y(0) - 8.75*y(1),
+    -10.03*y(2) + 0.43*y(3) + 0.035*y(4),
+    8.32*y(1) + 1.71*y(2) - 1.12*y(3),
+    -1.745*y(4) + 0.43*y(5) + 0.43*y(6),
+    -l*280*y(5)*y(7) + 0.69*y(3) + 1.71*y(4) - 0.43*y(5) + 0.69*y(6),
+    l*280*y(5)*y(7) - 1.81*y(6),
+    -k*280*y(5)*y(7) + 1.81*y(6)});
+  return {{{"x", y}, {"p", p}, {"ode", f}}, 321.8122,
+          {1, 0, 0, 0, 0, 0, 0, 0.0057}, {1, 1}};
+}
+
+// Oregonator, Belousov-Zhabotinsky reaction, stiff
+OdeProblem oregonator() {
+  SX y = SX::sym("y", 3), p = SX::sym("p");
+  SX f = vertcat(77.27*(y(1) + y(0)*(1 - 8.375e-6*y(0) - y(1))),
+                 (y(2) - (1 + y(0))*y(1))/77.27,
+                 p*(y(0) - y(2)));
+  return {{{"x", y}, {"p", p}, {"ode", f}}, 30, {1, 2, 3}, {0.161}};
+}
+
+// Viscous Burgers equation, central differences on n interior points
+OdeProblem burgers(casadi_int n) {
+  SX u = SX::sym("u", n), nu = SX::sym("nu");
+  double dx = 1./static_cast<double>(n+1);
+  std::vector<SX> f(n);
+  for (casadi_int i=0; i<n; ++i) {
+    SX ul = i>0 ? SX(u(i-1)) : SX(0), ur = i+1<n ? SX(u(i+1)) : SX(0), ui = u(i);
+    f[i] = nu*(ul - 2*ui + ur)/(dx*dx) - ui*(ur - ul)/(2*dx);
+  }
+  std::vector<double> u0(n);
+  for (casadi_int i=0; i<n; ++i) u0[i] = sin(pi*static_cast<double>(i+1)*dx);
+  return {{{"x", u}, {"p", nu}, {"ode", vertcat(f)}}, 0.5, u0, {0.01}};
+}
+
+/// Integrator configuration
+struct IntegratorConfig {
+  std::string plugin;
+  Dict params, opts;
+};
+
+std::vector<IntegratorConfig> integrator_configs(const Benchmark& b) {
+  std::vector<IntegratorConfig> ret;
+  for (double tol : std::vector<double>{1e-4, 1e-6, 1e-8}) {
+    // Tight absolute tolerances for the small concentrations in the kinetics problems
+    Dict sun_opts = {{"reltol", tol}, {"abstol", tol*1e-4}, {"max_num_steps", 100000}};
+    if (has_integrator("cvodes")) {
+      ret.push_back({"cvodes", {{"tol", tol}, {"method", "bdf"}}, sun_opts});
+      ret.push_back({"cvodes", {{"tol", tol}, {"method", "adams"}},
+                     merge(sun_opts, {{"linear_multistep_method", "adams"}})});
+    }
+    if (has_integrator("idas")) {
+      ret.push_back({"idas", {{"tol", tol}}, sun_opts});
+    }
+    if (b.quick()) break;
+  }
+  for (casadi_int nfe : b.sizes({20, 200, 2000})) {
+    if (has_integrator("rk")) {
+      ret.push_back({"rk", {{"nfe", nfe}}, {{"number_of_finite_elements", nfe}}});
+    }
+  }
+  for (casadi_int nfe : b.sizes({10, 40, 160})) {
+    if (has_integrator("collocation")) {
+      ret.push_back({"collocation", {{"nfe", nfe}},
+                     {{"number_of_finite_elements", nfe}, {"interpolation_order", 3}}});
+    }
+  }
+  return ret;
+}
+
+// Reference solution, with tight tolerances
+std::vector<double> reference(const OdeProblem& p) {
+  Function F;
+  Dict opts = {{"tf", p.tf}};
+  if (has_integrator("cvodes")) {
+    F = integrator("ref", "cvodes", p.dae, merge(opts, {{"reltol", 1e-12}, {"abstol", 1e-14},
+                                                       {"max_num_steps", 1000000}}));
+  } else {
+    F = integrator("ref", "rk", p.dae, merge(opts, {{"number_of_finite_elements", 100000}}));
+  }
+  return F(DMDict{{"x0", p.x0}, {"p", p.p}}).at("xf").nonzeros();
+}
+
+// Relative error in the infinity norm, infinite for a diverged solution
+double rel_error(const std::vector<double>& x, const std::vector<double>& ref) {
+  double e = 0, n = 0;
+  for (casadi_int i=0; i<x.size(); ++i) {
+    if (!std::isfinite(x[i])) return inf;
+    e = std::max(e, std::fabs(x[i] - ref[i]));
+    n = std::max(n, std::fabs(ref[i]));
+  }
+  return e/std::max(n, 1e-10);
+}
+
+void run_problem(Benchmark& b, const std::string& name, const Dict& prob_params,
+                 const OdeProblem& p, const std::vector<IntegratorConfig>& configs) {
+  if (!b.active("integrator_" + name)) return;
+  std::vector<double> ref = reference(p);
+  for (auto&& c : configs) {
+    Dict params = merge(prob_params, merge(c.params, {{"solver", c.plugin}}));
+    Function F, F_fwd, F_adj;
+    casadi_int n_alloc_init, n_alloc_eval;
+    std::vector<double> xf;
+    try {
+      // Memory objects allocated during construction and by an evaluation
+      PerfCounters::reset();
+      PerfCounters::enable();
+      F = integrator("F", c.plugin, p.dae, merge(c.opts, {{"tf", p.tf}}));
+      F(DMDict{{"x0", p.x0}, {"p", p.p}});
+      n_alloc_init = PerfCounters::count("checkout_alloc");
+      xf = F(DMDict{{"x0", p.x0}, {"p", p.p}}).at("xf").nonzeros();
+      n_alloc_eval = PerfCounters::count("checkout_alloc") - n_alloc_init;
+      PerfCounters::enable(false);
+      F_fwd = F.forward(1);
+      F_adj = F.reverse(1);
+    } catch (std::exception& e) {
+      PerfCounters::enable(false);
+      std::cerr << name << " " << str(params) << ": " << e.what() << std::endl;
+      b.record("integrator_" + name, params, {{"failed", true}});
+      continue;
+    }
+    Dict extra = {{"error", rel_error(xf, ref)}, {"n_alloc_init", n_alloc_init},
+                  {"n_alloc_eval", n_alloc_eval},
+                  {"memory", F.memory_footprint().at("total")}};
+    // Nominal integration and sensitivities
+    std::vector<std::pair<std::string, Function> > fcns = {
+      {"integrator_" + name, F}, {"integrator_fwd_" + name, F_fwd},
+      {"integrator_adj_" + name, F_adj}};
+    for (auto&& f : fcns) {
+      FunctionEval f_eval(f.second);
+      f_eval.set("x0", p.x0);
+      f_eval.set("p", p.p);
+      try {
+        if (!b.run(f.first, params, [&]() { f_eval();}, extra)) continue;
+      } catch (std::exception& e) {
+        std::cerr << f.first << " " << str(params) << ": " << e.what() << std::endl;
+        b.record(f.first, params, {{"failed", true}});
+        continue;
+      }
+      // Solver statistics, for the nominal integration
+      if (f.second.get()==F.get()) {
+        Dict stats = F.stats();
+        for (const char* k : {"nsteps", "nfevals", "nlinsetups", "netfails"}) {
+          if (stats.count(k)) b.annotate({{k, stats.at(k)}});
+        }
+      }
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Benchmark b("casadi_integrator_benchmarks", argc, argv);
+  std::vector<IntegratorConfig> configs = integrator_configs(b);
+  run_problem(b, "robertson", Dict(), robertson(), configs);
+  run_problem(b, "van_der_pol", {{"mu", 1}}, van_der_pol(1), configs);
+  run_problem(b, "van_der_pol", {{"mu", 1000}}, van_der_pol(1000), configs);
+  run_problem(b, "hires", Dict(), hires(), configs);
+  run_problem(b, "oregonator", Dict(), oregonator(), configs);
+  for (casadi_int n : b.sizes({20, 100, 400})) {
+    run_problem(b, "burgers", {{"n", n}}, burgers(n), configs);
+  }
+  return b.finish();
+}
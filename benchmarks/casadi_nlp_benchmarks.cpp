@@ -0,0 +1,314 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief End-to-end NLP and QP solver benchmarks
+
+    A collection of NLPs and optimal control problems, each parametrized by its
+    size, solved with every available nlpsol (and qpsol) configuration. The wall
+    time per solve, the iteration count, the return status and the time spent
+    in each oracle function are reported.
+*/
+
+#include "benchmark.hpp"
+
+using namespace casadi;
+using namespace benchmark;
+
+/// Test problem
+struct Problem {
+  SXDict nlp;
+  DMDict arg;
+};
+
+// Extended Rosenbrock function, unconstrained
+Problem rosenbrock(casadi_int n) {
+  SX x = SX::sym("x", n);
+  SX f = 0;
+  for (casadi_int i=0; i+1<n; ++i) {
+    SX xi = x(i), xn = x(i+1);
+    f += 100*sq(xn - sq(xi)) + sq(1 - xi);
+  }
+  std::vector<double> x0(n);
+  for (casadi_int i=0; i<n; ++i) x0[i] = i % 2 == 0 ? -1.2 : 1.;
+  return {{{"x", x}, {"f", f}}, {{"x0", x0}}};
+}
+
+// Hanging chain of n masses with fixed ends and inextensible links, in a box
+Problem chain(casadi_int n) {
+  SX y = SX::sym("y", n), z = SX::sym("z", n);
+  double L = 2./static_cast<double>(n+1);
+  SX f = 0;
+  std::vector<SX> g;
+  SX y_prev = 0, z_prev = 0;
+  for (casadi_int i=0; i<=n; ++i) {
+    SX y_next = i<n ? y(i) : SX(1), z_next = i<n ? z(i) : SX(0);
+    if (i<n) f += z(i);
+    g.push_back(sq(y_next - y_prev) + sq(z_next - z_prev));
+    y_prev = y_next;
+    z_prev = z_next;
+  }
+  std::vector<double> y0(n), z0(n, -0.1);
+  for (casadi_int i=0; i<n; ++i) y0[i] = static_cast<double>(i+1)/static_cast<double>(n+1);
+  return {{{"x", vertcat(y, z)}, {"f", f}, {"g", vertcat(g)}},
+          {{"x0", vertcat(DM(y0), DM(z0))}, {"lbx", -1}, {"ubx", 1},
+           {"lbg", -inf}, {"ubg", L*L}}};
+}
+
+// Rocket with friction and fuel consumption, single shooting, from docs/examples
+Problem rocket(casadi_int nu) {
+  casadi_int nj = 10;
+  SX u = SX::sym("u", nu);
+  SX s = 0, v = 0, m = 1;
+  double dt = 10.0/static_cast<double>(nj*nu);
+  std::vector<SX> v_k;
+  for (casadi_int k=0; k<nu; ++k) {
+    for (casadi_int j=0; j<nj; ++j) {
+      s += dt*v;
+      v += dt/m*(u(k) - 0.05*v*v);
+      m += -dt*0.1*u(k)*u(k);
+    }
+    v_k.push_back(v);
+  }
+  std::vector<double> lbg = {10, 0}, ubg = {10, 0};
+  lbg.resize(2+nu, -inf);
+  ubg.resize(2+nu, 1.1);
+  return {{{"x", u}, {"f", dot(u, u)}, {"g", vertcat(s, v, vertcat(v_k))}},
+          {{"x0", 0.4}, {"lbx", -10}, {"ubx", 10}, {"lbg", lbg}, {"ubg", ubg}}};
+}
+
+/** Optimal control problem, direct multiple shooting with RK4
+    ode: (x, u) -> xdot, l: (x, u) -> stage cost
+    Terminal states with NaN values are free
+*/
+Problem multiple_shooting(const Function& ode, const Function& l, double T, casadi_int N,
+                          const std::vector<double>& x0, const std::vector<double>& xf,
+                          const std::vector<double>& lbx, const std::vector<double>& ubx,
+                          const std::vector<double>& lbu, const std::vector<double>& ubu) {
+  casadi_int nx = ode.nnz_in(0), nu = ode.nnz_in(1);
+  // One RK4 step per interval
+  SX x = SX::sym("x", nx), u = SX::sym("u", nu);
+  double h = T/static_cast<double>(N);
+  SX k1 = ode(SXVector{x, u})[0];
+  SX k2 = ode(SXVector{x + h/2*k1, u})[0];
+  SX k3 = ode(SXVector{x + h/2*k2, u})[0];
+  SX k4 = ode(SXVector{x + h*k3, u})[0];
+  SX xn = x + h/6*(k1 + 2*k2 + 2*k3 + k4);
+  SX q = h*l(SXVector{x, u})[0];
+  Function F("F", {x, u}, {xn, q});
+  // Decision variables
+  std::vector<SX> X, U, w, g;
+  std::vector<double> lbw, ubw, w0;
+  SX J = 0;
+  for (casadi_int k=0; k<=N; ++k) {
+    X.push_back(SX::sym("X" + str(k), nx));
+    w.push_back(X.back());
+    for (casadi_int i=0; i<nx; ++i) {
+      if (k==0) {
+        lbw.push_back(x0[i]);
+        ubw.push_back(x0[i]);
+      } else if (k==N && !std::isnan(xf[i])) {
+        lbw.push_back(xf[i]);
+        ubw.push_back(xf[i]);
+      } else {
+        lbw.push_back(lbx[i]);
+        ubw.push_back(ubx[i]);
+      }
+      w0.push_back(x0[i]);
+    }
+    if (k==N) break;
+    U.push_back(SX::sym("U" + str(k), nu));
+    w.push_back(U.back());
+    lbw.insert(lbw.end(), lbu.begin(), lbu.end());
+    ubw.insert(ubw.end(), ubu.begin(), ubu.end());
+    w0.resize(w0.size() + nu, 0);
+  }
+  for (casadi_int k=0; k<N; ++k) {
+    std::vector<SX> r = F(std::vector<SX>{X[k], U[k]});
+    J += r[1];
+    g.push_back(r[0] - X[k+1]);
+  }
+  return {{{"x", vertcat(w)}, {"f", J}, {"g", vertcat(g)}},
+          {{"x0", w0}, {"lbx", lbw}, {"ubx", ubw}, {"lbg", 0}, {"ubg", 0}}};
+}
+
+// Cart-pole swing-up with a force penalty
+Problem cart_pole(casadi_int N) {
+  SX x = SX::sym("x", 4), u = SX::sym("u");
+  SX p = x(0), theta = x(1), v = x(2), omega = x(3);
+  double mc = 1, mp = 0.1, l = 0.5, g = 9.81;
+  SX den = mc + mp*sq(sin(theta));
+  SX a = (u + mp*sin(theta)*(l*sq(omega) + g*cos(theta)))/den;
+  SX alpha = -(u*cos(theta) + mp*l*sq(omega)*cos(theta)*sin(theta) + (mc+mp)*g*sin(theta))
+    /(l*den);
+  Function ode("ode", {x, u}, {vertcat(v, omega, a, alpha)});
+  Function stage("l", {x, u}, {sq(u) + sq(p)});
+  return multiple_shooting(ode, stage, 3, N, {0, 0, 0, 0}, {0, pi, 0, 0},
+                           std::vector<double>(4, -inf), std::vector<double>(4, inf), {-20}, {20});
+}
+
+// Exothermic CSTR in dimensionless form, steering the conversion to a setpoint
+Problem cstr(casadi_int N) {
+  SX x = SX::sym("x", 2), u = SX::sym("u");
+  double Da = 0.072, B = 8, beta = 0.3, gamma = 20;
+  SX r = Da*(1 - x(0))*exp(x(1)/(1 + x(1)/gamma));
+  Function ode("ode", {x, u}, {vertcat(-x(0) + r, -x(1) + B*r - beta*(x(1) - u))});
+  Function stage("l", {x, u}, {sq(x(0) - 0.5) + 0.01*sq(x(1) - 2) + 0.01*sq(u)});
+  return multiple_shooting(ode, stage, 10, N, {0.1, 0.5}, {casadi::nan, casadi::nan},
+                           {0, 0}, {1, 6}, {-2}, {2});
+}
+
+/// Solver configuration
+struct SolverConfig {
+  std::string name, plugin, qpsol;
+  Dict opts;
+  // Largest number of decision variables attempted
+  casadi_int max_nx;
+  // Does the solver require an MX formulation?
+  bool mx;
+};
+
+std::vector<SolverConfig> solver_configs() {
+  Dict qrqp_opts = {{"print_iter", false}, {"print_header", false}};
+  Dict qpoases_opts = {{"printLevel", "none"}};
+  Dict sqp_opts = {{"print_time", false}, {"print_header", false},
+                   {"print_iteration", false}, {"print_status", false}};
+  std::vector<SolverConfig> ret = {
+    {"ipopt", "ipopt", "", {{"ipopt.print_level", 0}, {"print_time", false},
+                            {"ipopt.sb", "yes"}}, 100000, false},
+    {"sqpmethod_qrqp", "sqpmethod", "qrqp",
+      merge(sqp_opts, {{"qpsol", "qrqp"}, {"qpsol_options", qrqp_opts}}), 200, false},
+    {"sqpmethod_qpoases", "sqpmethod", "qpoases",
+      merge(sqp_opts, {{"qpsol", "qpoases"}, {"qpsol_options", qpoases_opts}}), 2000, false},
+    {"blocksqp", "blocksqp", "", {{"print_time", false}, {"print_header", false},
+                                  {"print_iteration", false}}, 2000, false},
+    {"scpgen_qrqp", "scpgen", "qrqp", {{"print_time", false}, {"print_header", false},
+      {"qpsol", "qrqp"}, {"qpsol_options", qrqp_opts}}, 100, true}
+  };
+  // Only keep available plugins
+  std::vector<SolverConfig> avail;
+  for (auto&& s : ret) {
+    if (!has_nlpsol(s.plugin)) continue;
+    if (!s.qpsol.empty() && !has_conic(s.qpsol)) continue;
+    avail.push_back(s);
+  }
+  return avail;
+}
+
+// Time spent in the oracle functions, per function, from solver statistics
+Dict oracle_times(const Function& solver, double& t_oracle) {
+  Dict ret;
+  t_oracle = 0;
+  for (auto&& s : solver.stats()) {
+    // The solver itself is also timed
+    if (s.first.find("t_wall_")==0 && s.first!="t_wall_" + solver.name()) {
+      double t = s.second.to_double();
+      ret[s.first.substr(7)] = t;
+      t_oracle += t;
+    }
+  }
+  return ret;
+}
+
+// Solve a problem with every available solver configuration
+void solve(Benchmark& b, const std::string& name, casadi_int n,
+           const std::function<Problem(casadi_int)>& problem,
+           const std::vector<SolverConfig>& solvers) {
+  if (!b.active("nlp_" + name)) return;
+  Problem p = problem(n);
+  casadi_int nx = p.nlp.at("x").nnz(), ng = p.nlp.count("g") ? p.nlp.at("g").nnz() : 0;
+  for (auto&& s : solvers) {
+    if (nx>s.max_nx) continue;
+    Dict params = {{"n", n}, {"solver", s.name}};
+    Function solver;
+    try {
+      if (s.mx) {
+        // Embed the SX formulation as a single call
+        SXDict d = p.nlp;
+        if (!d.count("g")) d["g"] = SX(0, 1);
+        Function nlp = Function("nlp", d, {"x"}, {"f", "g"});
+        MX x = MX::sym("x", nx);
+        std::vector<MX> fg = nlp(std::vector<MX>{x});
+        solver = nlpsol("solver", s.plugin, {{"x", x}, {"f", fg[0]}, {"g", fg[1]}}, s.opts);
+      } else {
+        solver = nlpsol("solver", s.plugin, p.nlp, s.opts);
+      }
+    } catch (std::exception& e) {
+      std::cerr << name << " " << s.name << ": " << e.what() << std::endl;
+      continue;
+    }
+    DMDict res;
+    if (!b.run("nlp_" + name, params, [&]() { res = solver(p.arg);},
+               {{"nx", nx}, {"ng", ng}})) continue;
+    // Statistics of the last solve
+    Dict stats = solver.stats();
+    double t_oracle;
+    Dict extra = {{"oracle", oracle_times(solver, t_oracle)}, {"t_oracle", t_oracle},
+                  {"f", static_cast<double>(res.at("f"))}};
+    for (const char* k : {"iter_count", "success", "return_status"}) {
+      if (stats.count(k)) extra[k] = stats.at(k);
+    }
+    b.annotate(extra);
+  }
+}
+
+// Linear-quadratic OCP, the cart-pole linearized around the hanging position
+void qp_benchmarks(Benchmark& b) {
+  std::vector<std::string> plugins;
+  for (std::string p : {"qrqp", "qpoases", "osqp", "hpmpc", "ooqp", "cplex", "gurobi"}) {
+    if (has_conic(p)) plugins.push_back(p);
+  }
+  for (casadi_int N : b.sizes({10, 40, 100})) {
+    if (!b.active("qp_cart_pole")) return;
+    SX x = SX::sym("x", 4), u = SX::sym("u");
+    double g = 9.81, l = 0.5;
+    Function ode("ode", {x, u}, {vertcat(x(2), x(3), u + 0.1*g*x(1), -(u + 1.1*g*x(1))/l)});
+    Function stage("l", {x, u}, {sq(u) + dot(x, x)});
+    Problem p = multiple_shooting(ode, stage, 3, N, {0, 0.2, 0, 0}, {0, 0, 0, 0},
+                                  std::vector<double>(4, -inf), std::vector<double>(4, inf),
+                                  {-5}, {5});
+    for (auto&& s : plugins) {
+      Dict opts;
+      if (s=="qrqp") opts = {{"print_iter", false}, {"print_header", false}};
+      if (s=="qpoases") opts = {{"printLevel", "none"}};
+      Function solver = qpsol("solver", s, p.nlp, opts);
+      DMDict res;
+      if (!b.run("qp_cart_pole", {{"n", N}, {"solver", s}}, [&]() { res = solver(p.arg);},
+                 {{"nx", p.nlp.at("x").nnz()}})) continue;
+      b.annotate({{"f", static_cast<double>(res.at("f"))}});
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Benchmark b("casadi_nlp_benchmarks", argc, argv);
+  std::vector<SolverConfig> solvers = solver_configs();
+  for (casadi_int n : b.sizes({10, 100, 1000})) solve(b, "rosenbrock", n, rosenbrock, solvers);
+  for (casadi_int n : b.sizes({10, 40, 160})) solve(b, "chain", n, chain, solvers);
+  for (casadi_int n : b.sizes({10, 20, 40})) solve(b, "rocket", n, rocket, solvers);
+  for (casadi_int n : b.sizes({20, 50, 100})) solve(b, "cart_pole", n, cart_pole, solvers);
+  for (casadi_int n : b.sizes({20, 50, 200})) solve(b, "cstr", n, cstr, solvers);
+  qp_benchmarks(b);
+  return b.finish();
+}
@@ -0,0 +1,97 @@
+#
+#     This file is part of CasADi.
+#
+#     CasADi -- A symbolic framework for dynamic optimization.
+#     Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+#                             K.U. Leuven. All rights reserved.
+#     Copyright (C) 2011-2014 Greg Horn
+#
+#     CasADi is free software; you can redistribute it and/or
+#     modify it under the terms of the GNU Lesser General Public
+#     License as published by the Free Software Foundation; either
+#     version 3 of the License, or (at your option) any later version.
+#
+#     CasADi is distributed in the hope that it will be useful,
+#     but WITHOUT ANY WARRANTY; without even the implied warranty of
+#     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+#     Lesser General Public License for more details.
+#
+#     You should have received a copy of the GNU Lesser General Public
+#     License along with CasADi; if not, write to the Free Software
+#     Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+#
+"""
+Compare two sets of benchmark results, as written by the C++ benchmarks
+
+  python compare.py baseline.json current.json [--tolerance=0.1] [--key=time.median]
+
+Results are matched by name and parameters. The script exits with status 1 if
+any benchmark is slower than the baseline by more than the tolerance (relative).
+Several result files can be given per side, separated by commas.
+"""
+from __future__ import print_function
+import json
+import sys
+
+def load(fnames):
+  ret = {}
+  for fname in fnames.split(","):
+    with open(fname) as f:
+      data = json.load(f)
+    for r in data["results"]:
+      key = data["suite"] + "/" + r["name"] + " " + json.dumps(r["params"], sort_keys=True)
+      ret[key] = r
+  return ret
+
+def get(r, path):
+  for k in path.split("."):
+    if not isinstance(r, dict) or k not in r: return None
+    r = r[k]
+  return r
+
+def main(argv):
+  tolerance = 0.1
+  path = "time.median"
+  files = []
+  for a in argv:
+    if a.startswith("--tolerance="):
+      tolerance = float(a[len("--tolerance="):])
+    elif a.startswith("--key="):
+      path = a[len("--key="):]
+    else:
+      files.append(a)
+  if len(files)!=2:
+    print(__doc__)
+    return 2
+
+  base = load(files[0])
+  cur = load(files[1])
+
+  n_regress = 0
+  print("%-70s %12s %12s %8s" % ("benchmark", "baseline", "current", "ratio"))
+  for key in sorted(cur.keys()):
+    c = get(cur[key], path)
+    b = get(base[key], path) if key in base else None
+    if c is None or b is None or b<=0:
+      print("%-70s %12s %12s %8s" % (key, "-" if b is None else "%.4g" % b,
+                                     "-" if c is None else "%.4g" % c, "-"))
+      continue
+    ratio = c/b
+    flag = ""
+    if ratio>1+tolerance:
+      flag = " SLOWER"
+      n_regress += 1
+    elif ratio<1/(1+tolerance):
+      flag = " faster"
+    print("%-70s %12.4g %12.4g %8.3f%s" % (key, b, c, ratio, flag))
+  for key in sorted(set(base.keys())-set(cur.keys())):
+    print("%-70s %12s %12s %8s" % (key, "%.4g" % get(base[key], path), "-", "missing"))
+
+  if n_regress>0:
+    print("%d benchmark(s) slower than baseline by more than %g%%" % (n_regress, 100*tolerance))
+    return 1
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main(sys.argv[1:]))
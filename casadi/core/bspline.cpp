@@ -275,6 +275,59 @@ namespace casadi {
       return Function(name, {x, dummy}, {jac(x)}, opts);
     }
 
+    Function BSpline::get_value_jacobian(const std::string& name,
+          const std::vector<std::string>& inames,
+          const std::vector<std::string>& onames, const Dict& opts) const {
+      Function ret;
+      ret.own(new BSplineValJac(name, self()));
+      ret->construct(opts);
+      return ret;
+    }
+
+    void BSplineValJac::init(const Dict& opts) {
+      FunctionInternal::init(opts);
+
+      const BSpline* s = spline_.get<BSpline>();
+      casadi_int n_boor = 0, max_degree = 0;
+      for (casadi_int d : s->degree_) {
+        n_boor += d+1;
+        max_degree = std::max(max_degree, d);
+      }
+      alloc_w(2*n_boor+max_degree, true); // boor, dboor
+      alloc_iw(3*s->degree_.size()+1, true); // boor_offset, starts, index
+    }
+
+    int BSplineValJac::eval(const double** arg, double** res,
+                            casadi_int* iw, double* w, void* mem) const {
+      const BSpline* s = spline_.get<BSpline>();
+      casadi_nd_boor_val_grad(res[0], res[1], s->degree_.size(), get_ptr(s->knots_),
+        get_ptr(s->offset_), get_ptr(s->degree_), get_ptr(s->strides_), get_ptr(s->coeffs_),
+        s->m_, arg[0], get_ptr(s->lookup_mode_), iw, w);
+      return 0;
+    }
+
+    void BSplineValJac::codegen_body(CodeGenerator& g) const {
+      const BSpline* s = spline_.get<BSpline>();
+      g.add_auxiliary(CodeGenerator::AUX_ND_BOOR_VAL_GRAD);
+      g << "  CASADI_PREFIX(nd_boor_val_grad)(res[0], res[1], " << s->degree_.size() << ","
+        << g.constant(s->knots_) << "," << g.constant(s->offset_) << ","
+        << g.constant(s->degree_) << "," << g.constant(s->strides_) << ","
+        << g.constant(s->coeffs_) << "," << s->m_  << ",arg[0],"
+        << g.constant(s->lookup_mode_) << ", iw, w);\n";
+    }
+
+    Function BSplineValJac::get_jacobian(const std::string& name,
+          const std::vector<std::string>& inames,
+          const std::vector<std::string>& onames, const Dict& opts) const {
+      const BSpline* s = spline_.get<BSpline>();
+      MX x = MX::sym(inames.at(0), sparsity_in(0));
+      MX v = MX::sym(inames.at(1), Sparsity(size_out(0)));
+      MX J = MX::sym(inames.at(2), sparsity_out(1));
+      // Jacobian of the value is available as nondifferentiated output
+      MX H = MX::jacobian(vec(s->jac(x)), x);
+      return Function(name, {x, v, J}, {vertcat(J, H)}, opts);
+    }
+
     Sparsity BSplineDual::get_sparsity_in(casadi_int i) {
       if (reverse_) return Sparsity::dense(m_, N_);
       return Sparsity::dense(coeffs_size_);
@@ -122,6 +122,15 @@ namespace casadi {
                           const Dict& opts) const override;
     ///@}
 
+    ///@{
+    /** \brief Value and Jacobian, sharing the knot lookup */
+    bool has_value_jacobian() const override { return true;}
+    Function get_value_jacobian(const std::string& name,
+                                const std::vector<std::string>& inames,
+                                const std::vector<std::string>& onames,
+                                const Dict& opts) const override;
+    ///@}
+
     /** \brief Is codegen supported? */
     bool has_codegen() const override { return true;}
 
@@ -136,6 +145,44 @@ namespace casadi {
   private:
     std::vector<double> derivative_coeff(casadi_int i) const;
     MX jac(const MX& x) const;
+    friend class BSplineValJac;
+  };
+
+  /** Value and Jacobian of a BSpline */
+  class BSplineValJac : public FunctionInternal {
+  public:
+    BSplineValJac(const std::string &name, const Function& spline) :
+      FunctionInternal(name), spline_(spline) {}
+
+    /** \brief  Destructor */
+    ~BSplineValJac() override {}
+
+    /** \brief  Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief  Evaluate numerically, work vectors given */
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    ///@{
+    /** \brief Return Jacobian of all input elements with respect to all output elements */
+    bool has_jacobian() const override { return true;}
+    Function get_jacobian(const std::string& name,
+                          const std::vector<std::string>& inames,
+                          const std::vector<std::string>& onames,
+                          const Dict& opts) const override;
+    ///@}
+
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+    void codegen_declarations(CodeGenerator& g) const override {};
+
+    std::string class_name() const override { return "BSplineValJac"; }
+
+    // Spline being evaluated
+    Function spline_;
   };
 
 
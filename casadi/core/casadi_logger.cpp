@@ -24,24 +24,137 @@
 
 #include "casadi_common.hpp"
 #include "casadi_logger.hpp"
+#include "exception.hpp"
 
 #ifdef CASADI_WITH_THREAD
 #ifdef CASADI_WITH_THREAD_MINGW
 #include <mingw.mutex.h>
+#include <mingw.thread.h>
 #else // CASADI_WITH_THREAD_MINGW
 #include <mutex>
+#include <thread>
 #endif // CASADI_WITH_THREAD_MINGW
+#include <atomic>
+#include <chrono>
+#include <vector>
 #endif //CASADI_WITH_THREAD
 
 namespace casadi {
 
 #ifdef CASADI_WITH_THREAD
   std::mutex mutex_logger;
+
+  namespace {
+    // Entry in the ring buffer: a line of text, a flush request or an iteration record
+    struct LogEntry {
+      enum Kind {TEXT, FLUSH, ITERATION} kind;
+      bool error;
+      size_t len;
+      char text[256];
+      Logger::Iteration rec;
+    };
+
+    /* Asynchronous output. The producers are serialized by mutex_logger, so
+       the ring buffer only needs to be safe for a single producer and the
+       background thread as single consumer, which is done with the atomic
+       head and tail counters. */
+    struct AsyncLog {
+      std::vector<LogEntry> buf;
+      size_t mask;
+      // Number of entries queued and processed
+      std::atomic<size_t> head, tail;
+      std::atomic<bool> running;
+      bool block;
+      std::atomic<casadi_int> n_dropped;
+      // Text not yet ending with a newline
+      LogEntry pending;
+      std::thread worker;
+
+      AsyncLog() : mask(0), head(0), tail(0), running(false), block(true), n_dropped(0) {
+        pending.error = false;
+        pending.len = 0;
+      }
+
+      // Stop the background thread at exit, if the user has not
+      ~AsyncLog() {
+        if (worker.joinable()) {
+          push_pending();
+          running = false;
+          worker.join();
+        }
+      }
+
+      // Queue an entry, called with mutex_logger locked
+      void push(const LogEntry& e) {
+        size_t h = head.load(std::memory_order_relaxed);
+        while (h - tail.load(std::memory_order_acquire) > mask) {
+          if (!block) {
+            n_dropped++;
+            return;
+          }
+          std::this_thread::yield();
+        }
+        buf[h & mask] = e;
+        head.store(h + 1, std::memory_order_release);
+      }
+
+      // Queue any pending text
+      void push_pending() {
+        if (pending.len==0) return;
+        pending.kind = LogEntry::TEXT;
+        push(pending);
+        pending.len = 0;
+      }
+
+      // Queue text, line by line
+      void write(const char* s, std::streamsize num, bool error) {
+        if (pending.error!=error) push_pending();
+        pending.error = error;
+        for (std::streamsize i=0; i<num; ++i) {
+          pending.text[pending.len++] = s[i];
+          if (s[i]=='\n' || pending.len==sizeof(pending.text)) push_pending();
+        }
+      }
+
+      // Background thread: pass the queued entries on to the sinks
+      void drain() {
+        while (true) {
+          // Read the flag first, so that no entry queued before stopping is lost
+          bool stopping = !running;
+          size_t t = tail.load(std::memory_order_relaxed);
+          if (t==head.load(std::memory_order_acquire)) {
+            if (stopping) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+          }
+          const LogEntry& e = buf[t & mask];
+          switch (e.kind) {
+            case LogEntry::TEXT:
+              Logger::writeFun(e.text, static_cast<std::streamsize>(e.len), e.error);
+              break;
+            case LogEntry::FLUSH:
+              Logger::flush(e.error);
+              break;
+            case LogEntry::ITERATION:
+              if (Logger::iterationFun) Logger::iterationFun(e.rec);
+              break;
+          }
+          tail.store(t + 1, std::memory_order_release);
+        }
+      }
+    };
+
+    AsyncLog async_log;
+  } // namespace
 #endif //CASADI_WITH_THREAD
 
   void Logger::WriteFunThreadSafe(const char* s, std::streamsize num, bool error) {
 #ifdef CASADI_WITH_THREAD
     std::lock_guard<std::mutex> lock(mutex_logger);
+    if (async_log.running) {
+      async_log.write(s, num, error);
+      return;
+    }
 #endif //CASADI_WITH_THREAD
     writeFun(s, num, error);
   }
@@ -49,15 +162,98 @@ namespace casadi {
   void Logger::FlushThreadSafe(bool error) {
 #ifdef CASADI_WITH_THREAD
     std::lock_guard<std::mutex> lock(mutex_logger);
+    if (async_log.running) {
+      async_log.push_pending();
+      LogEntry e;
+      e.kind = LogEntry::FLUSH;
+      e.error = error;
+      async_log.push(e);
+      return;
+    }
 #endif //CASADI_WITH_THREAD
     flush(error);
   }
 
+  void Logger::IterationThreadSafe(const Iteration& r) {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(mutex_logger);
+    if (async_log.running) {
+      LogEntry e;
+      e.kind = LogEntry::ITERATION;
+      e.rec = r;
+      async_log.push(e);
+      return;
+    }
+#endif //CASADI_WITH_THREAD
+    iterationFun(r);
+  }
+
+  void Logger::iteration(const char* solver, casadi_int iter,
+                         double obj, double pr_inf, double du_inf) {
+    // Not inlined: plugins are loaded with RTLD_DEEPBIND and would not see
+    // an iterationFun set by the executable
+    if (iterationFun) IterationThreadSafe({solver, iter, obj, pr_inf, du_inf});
+  }
+
+  void Logger::start_async(casadi_int capacity, bool block) {
+#ifdef CASADI_WITH_THREAD
+    casadi_assert(capacity>0, "Buffer capacity must be positive");
+    std::lock_guard<std::mutex> lock(mutex_logger);
+    casadi_assert(!async_log.running, "Asynchronous output already active");
+    // Capacity rounded up to a power of two
+    size_t n = 1;
+    while (n < static_cast<size_t>(capacity)) n *= 2;
+    async_log.buf.resize(n);
+    async_log.mask = n - 1;
+    async_log.head = 0;
+    async_log.tail = 0;
+    // Waiting would deadlock if the sink needs a lock held by the caller
+    async_log.block = block && !writeFunLocks;
+    async_log.n_dropped = 0;
+    async_log.pending.len = 0;
+    async_log.running = true;
+    async_log.worker = std::thread(&AsyncLog::drain, &async_log);
+#else // CASADI_WITH_THREAD
+    casadi_error("Asynchronous output requires CasADi to be compiled with thread support");
+#endif // CASADI_WITH_THREAD
+  }
+
+  void Logger::stop_async() {
+#ifdef CASADI_WITH_THREAD
+    // The lock is held until the buffer is drained, to preserve the order of the output
+    std::lock_guard<std::mutex> lock(mutex_logger);
+    if (!async_log.running) return;
+    async_log.push_pending();
+    async_log.running = false;
+    async_log.worker.join();
+#endif // CASADI_WITH_THREAD
+  }
+
+  bool Logger::is_async() {
+#ifdef CASADI_WITH_THREAD
+    return async_log.running;
+#else // CASADI_WITH_THREAD
+    return false;
+#endif // CASADI_WITH_THREAD
+  }
+
+  casadi_int Logger::n_dropped() {
+#ifdef CASADI_WITH_THREAD
+    return async_log.n_dropped;
+#else // CASADI_WITH_THREAD
+    return 0;
+#endif // CASADI_WITH_THREAD
+  }
+
   void (*Logger::writeFun)(const char* s, std::streamsize num, bool error) =
     Logger::writeDefault;
 
   void (*Logger::flush)(bool error) =Logger::flushDefault;
 
+  bool Logger::writeFunLocks = false;
+
+  void (*Logger::iterationFun)(const Iteration& r) = nullptr;
+
   std::ostream& uout() {
     // Singleton pattern
     static Logger::Stream<false> instance;
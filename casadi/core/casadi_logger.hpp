@@ -27,6 +27,7 @@
 #define CASADI_LOGGER_HPP
 
 #include <casadi/core/casadi_export.h>
+#include "casadi_types.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -52,8 +53,56 @@ namespace casadi {
     /// Flush buffers
     static void (*flush)(bool error);
 
+    /** \brief Does writeFun acquire a lock that the caller may hold?
+
+        E.g. the Python interpreter lock. Asynchronous output then never waits
+        for the background thread, which would need the same lock (default: false)
+    */
+    static bool writeFunLocks;
+
+    /// Structured record of a solver iteration
+    struct Iteration {
+      /// Reporting solver, a string with static storage duration
+      const char* solver;
+      /// Iteration number
+      casadi_int iter;
+      /// Objective, primal and dual infeasibility
+      double obj, pr_inf, du_inf;
+    };
+
+    /// Receive iteration records, can be redefined (default: none)
+    static void (*iterationFun)(const Iteration& r);
+
+    /// Report a solver iteration, a no-op unless iterationFun is set
+    static void iteration(const char* solver, casadi_int iter,
+                          double obj, double pr_inf, double du_inf);
+
+    /** \brief Start asynchronous output
+
+        Output and iteration records are queued in a lock-free ring buffer with
+        room for \a capacity entries and passed on to writeFun, flush and
+        iterationFun by a background thread, so that a slow sink does not stall
+        the calling thread. Text is queued line by line. When the buffer is full,
+        the caller waits for the background thread if \a block is true, otherwise
+        the entry is dropped and counted. A blocked caller holds the logger lock,
+        so if writeFunLocks is set, entries are always dropped instead. The sinks
+        must not be redefined while asynchronous output is active, and must not
+        depend on the calling thread.
+    */
+    static void start_async(casadi_int capacity=1024, bool block=true);
+
+    /// Drain the buffer and return to synchronous output
+    static void stop_async();
+
+    /// Is asynchronous output active?
+    static bool is_async();
+
+    /// Number of entries dropped since start_async, for a nonblocking buffer
+    static casadi_int n_dropped();
+
     static void WriteFunThreadSafe(const char* s, std::streamsize num, bool error);
     static void FlushThreadSafe(bool error);
+    static void IterationThreadSafe(const Iteration& r);
 
     /// By default, print to std::cout or std::cerr
     static void writeDefault(const char* s, std::streamsize num, bool error) {
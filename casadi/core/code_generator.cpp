@@ -693,9 +693,13 @@ namespace casadi {
       this->auxiliaries << sanitize_source(casadi_interpn_str, inst);
       break;
     case AUX_INTERPN_GRAD:
-      add_auxiliary(AUX_INTERPN);
+      add_auxiliary(AUX_INTERPN_VAL_GRAD);
       this->auxiliaries << sanitize_source(casadi_interpn_grad_str, inst);
       break;
+    case AUX_INTERPN_VAL_GRAD:
+      add_auxiliary(AUX_INTERPN);
+      this->auxiliaries << sanitize_source(casadi_interpn_val_grad_str, inst);
+      break;
     case AUX_DE_BOOR:
       this->auxiliaries << sanitize_source(casadi_de_boor_str, inst);
       break;
@@ -706,6 +710,13 @@ namespace casadi {
       add_auxiliary(AUX_LOW);
       this->auxiliaries << sanitize_source(casadi_nd_boor_eval_str, inst);
       break;
+    case AUX_ND_BOOR_VAL_GRAD:
+      add_auxiliary(AUX_DE_BOOR);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_FILL, {"casadi_int"});
+      add_auxiliary(AUX_LOW);
+      this->auxiliaries << sanitize_source(casadi_nd_boor_val_grad_str, inst);
+      break;
     case AUX_FLIP:
       this->auxiliaries << sanitize_source(casadi_flip_str, inst);
       break;
@@ -789,6 +800,50 @@ namespace casadi {
       add_auxiliary(AUX_QR);
       this->auxiliaries << sanitize_source(casadi_newton_str, inst);
       break;
+    case AUX_MAX_VIOL:
+      add_auxiliary(AUX_FMAX);
+      this->auxiliaries << sanitize_source(casadi_max_viol_str, inst);
+      break;
+    case AUX_BFGS:
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_MV);
+      add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_SCAL);
+      add_auxiliary(AUX_RANK1);
+      add_auxiliary(AUX_IF_ELSE);
+      this->auxiliaries << sanitize_source(casadi_bfgs_str, inst);
+      break;
+    case AUX_REGULARIZE:
+      add_auxiliary(AUX_FMIN);
+      this->auxiliaries << sanitize_source(casadi_regularize_str, inst);
+      break;
+    case AUX_BOUNDS_CONSISTENCY:
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      this->auxiliaries << sanitize_source(casadi_bound_consistency_str, inst);
+      break;
+    case AUX_QP:
+      add_auxiliary(AUX_MAX);
+      add_auxiliary(AUX_FMIN);
+      add_auxiliary(AUX_FMAX);
+      add_auxiliary(AUX_COPY);
+      add_auxiliary(AUX_FILL);
+      add_auxiliary(AUX_SCAL);
+      add_auxiliary(AUX_AXPY);
+      add_auxiliary(AUX_DOT);
+      add_auxiliary(AUX_BILIN);
+      add_auxiliary(AUX_MV);
+      add_auxiliary(AUX_TRANS);
+      add_auxiliary(AUX_QR);
+      add_include("stdarg.h");
+      add_include("stdio.h");
+      this->auxiliaries << sanitize_source(casadi_qp_str, inst);
+      break;
+    case AUX_MAX:
+      this->auxiliaries << "#define casadi_max(x, y) ((x)>(y) ? (x) : (y))\n\n";
+      break;
     case AUX_TO_DOUBLE:
       this->auxiliaries << "#define casadi_to_double(x) "
                         << "(" << (this->cpp ? "static_cast<double>(x)" : "(double) x") << ")\n\n";
@@ -988,6 +1043,19 @@ namespace casadi {
     return s.str();
   }
 
+  string CodeGenerator::interpn_val_grad(const string& res, const string& grad,
+                                   casadi_int ndim, const string& grid, const string& offset,
+                                   const string& values, const string& x,
+                                   const string& lookup_mode, casadi_int m,
+                                   const string& iw, const string& w) {
+    add_auxiliary(AUX_INTERPN_VAL_GRAD);
+    stringstream s;
+    s << "casadi_interpn_val_grad(" << res << ", " << grad << ", " << ndim << ", " << grid << ", "
+      << offset << ", " << values << ", " << x << ", " << lookup_mode << ", " << m << ", "
+      << iw << ", " << w << ");";
+    return s.str();
+  }
+
   string CodeGenerator::trans(const string& x, const Sparsity& sp_x,
                                    const string& y, const Sparsity& sp_y,
                                    const string& iw) {
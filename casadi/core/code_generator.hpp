@@ -198,6 +198,14 @@ namespace casadi {
       const std::string& lookup_mode, casadi_int m,
       const std::string& iw, const std::string& w);
 
+    /** \brief Multilinear interpolation - calculate value and gradient */
+    std::string interpn_val_grad(const std::string& res, const std::string& grad,
+      casadi_int ndim, const std::string& grid,
+      const std::string& offset,
+      const std::string& values, const std::string& x,
+      const std::string& lookup_mode, casadi_int m,
+      const std::string& iw, const std::string& w);
+
     /** \brief Transpose */
     std::string trans(const std::string& x, const Sparsity& sp_x,
       const std::string& y, const Sparsity& sp_y, const std::string& iw);
@@ -258,16 +266,24 @@ namespace casadi {
       AUX_FROM_MEX,
       AUX_INTERPN,
       AUX_INTERPN_GRAD,
+      AUX_INTERPN_VAL_GRAD,
       AUX_FLIP,
       AUX_INTERPN_WEIGHTS,
       AUX_LOW,
       AUX_INTERPN_INTERPOLATE,
       AUX_DE_BOOR,
       AUX_ND_BOOR_EVAL,
+      AUX_ND_BOOR_VAL_GRAD,
       AUX_FINITE_DIFF,
       AUX_QR,
       AUX_LDL,
       AUX_NEWTON,
+      AUX_MAX_VIOL,
+      AUX_BFGS,
+      AUX_REGULARIZE,
+      AUX_BOUNDS_CONSISTENCY,
+      AUX_QP,
+      AUX_MAX,
       AUX_TO_DOUBLE,
       AUX_TO_INT,
       AUX_CAST,
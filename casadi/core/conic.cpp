@@ -396,6 +396,116 @@ namespace casadi {
   Conic::~Conic() {
   }
 
+  void Conic::detect_ocp_structure(const Sparsity& A, std::vector<casadi_int>& nx,
+                                   std::vector<casadi_int>& nu, std::vector<casadi_int>& ng) {
+    casadi_int na = A.size1();
+    nx.clear();
+    nu.clear();
+    ng.clear();
+
+    /* General strategy: look for the xk+1 diagonal part in A
+    */
+
+    // Find the right-most column for each row in A -> A_skyline
+    // Find the second-to-right-most column -> A_skyline2
+    // Find the left-most column -> A_bottomline
+    Sparsity AT = A.T();
+    std::vector<casadi_int> A_skyline;
+    std::vector<casadi_int> A_skyline2;
+    std::vector<casadi_int> A_bottomline;
+    for (casadi_int i=0;i<AT.size2();++i) {
+      casadi_int pivot = AT.colind()[i+1];
+      if (pivot>AT.colind()[i]) {
+        A_bottomline.push_back(AT.row()[AT.colind()[i]]);
+        A_skyline.push_back(AT.row()[pivot-1]);
+        if (pivot>AT.colind()[i]+1) {
+          A_skyline2.push_back(AT.row()[pivot-2]);
+        } else {
+          A_skyline2.push_back(-1);
+        }
+      } else {
+        // Empty row
+        A_bottomline.push_back(A.size2());
+        A_skyline.push_back(-1);
+        A_skyline2.push_back(-1);
+      }
+    }
+
+    /*
+    Loop over the right-most columns of A:
+    they form the diagonal part due to xk+1 in gap constraints.
+    detect when the diagonal pattern is broken -> new stage
+    */
+    casadi_int pivot = 0; // Current right-most element
+    casadi_int start_pivot = pivot; // First right-most element that started the stage
+    casadi_int cg = 0; // Counter for non-gap-closing constraints
+    for (casadi_int i=0;i<na;++i) { // Loop over all rows
+      bool commit = false; // Set true to jump to the stage
+      if (A_skyline[i]>pivot+1) { // Jump to a diagonal in the future
+        nu.push_back(A_skyline[i]-pivot-1); // Size of jump equals number of states
+        commit = true;
+      } else if (A_skyline[i]==pivot+1) { // Walking the diagonal
+        if (A_skyline2[i]<start_pivot) { // Free of below-diagonal entries?
+          pivot++;
+        } else {
+          nu.push_back(0); // We cannot but conclude that we arrived at a new stage
+          commit = true;
+        }
+      } else { // non-gap-closing constraint detected
+        cg++;
+      }
+
+      if (commit) {
+        nx.push_back(pivot-start_pivot+1);
+        ng.push_back(cg); cg=0;
+        start_pivot = A_skyline[i];
+        pivot = A_skyline[i];
+      }
+    }
+    nx.push_back(pivot-start_pivot+1);
+
+    // No stage transition, e.g. no constraints: a single stage without dynamics
+    if (nu.empty()) {
+      nx = {A.size2()};
+      ng = {na};
+      return;
+    }
+
+    // Correction for k==0
+    nx[0] = A_skyline[0];
+    nu[0] = 0;
+    ng.erase(ng.begin());
+    casadi_int cN=0;
+    for (casadi_int i=na-1;i>=0;--i) {
+      if (A_bottomline[i]<start_pivot) break;
+      cN++;
+    }
+    ng.push_back(cg-cN);
+    ng.push_back(cN);
+
+    // The detected stages must account for all variables and constraints
+    casadi_int sum_x = 0, sum_g = 0;
+    bool nonneg = true;
+    for (casadi_int k=0; k<nx.size(); ++k) {
+      sum_x += nx[k];
+      if (k>0) sum_g += nx[k];
+      nonneg = nonneg && nx[k]>=0;
+    }
+    for (casadi_int e : nu) {
+      sum_x += e;
+      nonneg = nonneg && e>=0;
+    }
+    for (casadi_int e : ng) {
+      sum_g += e;
+      nonneg = nonneg && e>=0;
+    }
+    casadi_assert(nonneg && sum_x==A.size2() && sum_g==na,
+      "Cannot detect an OCP structure from the sparsity of A (" + A.dim() + "): "
+      "expected variables ordered as [x0 u0 x1 u1 ... xN] and constraints as "
+      "[gap0 g0 gap1 g1 ... gN], got nx " + str(nx) + ", nu " + str(nu) + ", "
+      "ng " + str(ng) + ". Provide the structure with the options N, nx, nu, ng.");
+  }
+
   void Conic::check_inputs(const double* lbx, const double* ubx,
                           const double* lba, const double* uba) const {
     for (casadi_int i=0; i<nx_; ++i) {
@@ -114,6 +114,15 @@ namespace casadi {
     /// Print statistics
     void print_fstats(const ConicMemory* m) const;
 
+    /** \brief Detect the stage structure of an OCP QP from the sparsity of A
+     *
+     * Variables are assumed to be ordered as [x0 u0 x1 u1 ... xN], constraints as
+     * [gap0 g0 gap1 g1 ... gN], with gap constraints of the form
+     * A_k x_k + B_k u_k + I_k x_{k+1}, I_k diagonal.
+     */
+    static void detect_ocp_structure(const Sparsity& A, std::vector<casadi_int>& nx,
+                                     std::vector<casadi_int>& nu, std::vector<casadi_int>& ng);
+
   protected:
     /// Options
     std::vector<bool> discrete_;
@@ -270,6 +270,59 @@ namespace casadi {
     return Function(name, ex_in, ex_out, name_in(), name_out(), opts);
   }
 
+  Function Function::specialize(const string& name, const DMDict& values,
+                                const Dict& opts) const {
+    try {
+      // Fixed input values, projected to the input sparsity patterns
+      vector<DM> v(n_in());
+      vector<bool> fixed(n_in(), false);
+      for (auto&& e : values) {
+        casadi_int i = index_in(e.first);
+        casadi_assert(e.second.size()==size_in(i),
+          "Dimension mismatch for input '" + e.first + "': Expected " + sparsity_in(i).dim()
+          + ", got " + e.second.dim(false) + ".");
+        v[i] = project(e.second, sparsity_in(i));
+        fixed[i] = true;
+      }
+
+      // Names of the remaining inputs
+      vector<string> ret_name_in;
+      for (casadi_int i=0; i<n_in(); ++i) {
+        if (!fixed[i]) ret_name_in.push_back(name_in(i));
+      }
+
+      if (is_a("SXFunction")) {
+        // Constants are folded when the expressions are created
+        vector<SX> arg = sx_in(), ret_in;
+        for (casadi_int i=0; i<arg.size(); ++i) {
+          if (fixed[i]) {
+            arg[i] = v[i];
+          } else {
+            ret_in.push_back(arg[i]);
+          }
+        }
+        return Function(name, ret_in, Function(*this)(arg), ret_name_in, name_out(), opts);
+      } else {
+        vector<MX> arg = mx_in(), ret_in, res;
+        for (casadi_int i=0; i<arg.size(); ++i) {
+          if (fixed[i]) {
+            arg[i] = v[i];
+          } else {
+            ret_in.push_back(arg[i]);
+          }
+        }
+        // Inline MXFunction, other functions (external, solvers, ...) are called
+        call(arg, res, is_a("MXFunction"));
+        // Evaluate the subexpressions that only depend on constants
+        Function tmp(name, ret_in, res, Dict{{"live_variables", false}});
+        res = static_cast<const MXFunction*>(tmp.get())->fold_constants();
+        return Function(name, ret_in, res, ret_name_in, name_out(), opts);
+      }
+    } catch (exception& e) {
+      THROW_ERROR("specialize", e.what());
+    }
+  }
+
   Function Function::create(FunctionInternal* node) {
     Function ret;
     ret.own(node);
@@ -1443,6 +1496,9 @@ namespace casadi {
           const AuxOut& aux,
           const Dict& opts) const {
      try {
+       // Works on the expression graph of the function, like derivative generation
+       FunctionInternal::GenerationLock lock;
+       lock.lock();
        return (*this)->factory(name, s_in, s_out, aux, opts);
      } catch (exception& e) {
        THROW_ERROR("factory", "Failed to create " + name + ":" + str(s_in) + "->" + str(s_out)
@@ -1505,5 +1561,70 @@ namespace casadi {
     return (*this)->info();
   }
 
+  Dict Function::memory_footprint() const {
+    try {
+      return (*this)->memory_footprint();
+    } catch(exception& e) {
+      THROW_ERROR("memory_footprint", e.what());
+    }
+  }
+
+  FunctionBuffer::FunctionBuffer(const Function& f) : f_(f) {
+    w_.resize(f_.sz_w());
+    iw_.resize(f_.sz_iw());
+    arg_.resize(f_.sz_arg(), nullptr);
+    res_.resize(f_.sz_res(), nullptr);
+    mem_ = f_.checkout();
+    ret_ = 0;
+  }
+
+  FunctionBuffer::~FunctionBuffer() {
+    f_.release(mem_);
+  }
+
+  FunctionBuffer::FunctionBuffer(const FunctionBuffer& f) : f_(f.f_), w_(f.w_), iw_(f.iw_),
+      arg_(f.arg_), res_(f.res_), ret_(f.ret_) {
+    mem_ = f_.checkout();
+  }
+
+  FunctionBuffer& FunctionBuffer::operator=(const FunctionBuffer& f) {
+    if (this==&f) return *this;
+    f_.release(mem_);
+    f_ = f.f_;
+    w_ = f.w_;
+    iw_ = f.iw_;
+    arg_ = f.arg_;
+    res_ = f.res_;
+    ret_ = f.ret_;
+    mem_ = f_.checkout();
+    return *this;
+  }
+
+  void FunctionBuffer::set_arg(casadi_int i, const double* a, casadi_int size) {
+    casadi_assert(i>=0 && i<f_.n_in(), "Input index " + str(i) + " out of bounds");
+    casadi_int expected = f_.nnz_in(i)*static_cast<casadi_int>(sizeof(double));
+    casadi_assert(size==expected,
+      "Buffer for input " + str(i) + " (" + f_.name_in(i) + ") has " + str(size)
+      + " bytes, expected " + str(expected) + ".");
+    arg_[i] = a;
+  }
+
+  void FunctionBuffer::set_res(casadi_int i, double* a, casadi_int size) {
+    casadi_assert(i>=0 && i<f_.n_out(), "Output index " + str(i) + " out of bounds");
+    casadi_int expected = f_.nnz_out(i)*static_cast<casadi_int>(sizeof(double));
+    casadi_assert(size==expected,
+      "Buffer for output " + str(i) + " (" + f_.name_out(i) + ") has " + str(size)
+      + " bytes, expected " + str(expected) + ".");
+    res_[i] = a;
+  }
+
+  void FunctionBuffer::_eval() {
+    ret_ = f_(get_ptr(arg_), get_ptr(res_), get_ptr(iw_), get_ptr(w_), mem_);
+  }
+
+  void _function_buffer_eval(void* raw) {
+    static_cast<FunctionBuffer*>(raw)->_eval();
+  }
+
 
 } // namespace casadi
@@ -187,6 +187,16 @@ namespace casadi {
                     const Dict& opts=Dict()) const;
     ///@}
 
+    /** \brief Specialize a function for fixed values of some of its inputs
+
+        The fixed inputs are removed from the function and their values are
+        propagated through the SX tape or, with calls to MX functions inlined,
+        the MX graph. Subexpressions that only depend on constants are evaluated
+        once and operations that are no longer needed are dropped.
+    */
+    Function specialize(const std::string& name, const DMDict& values,
+                        const Dict& opts=Dict()) const;
+
     /// \cond INTERNAL
 #ifndef SWIG
     /** \brief  Create from node */
@@ -911,6 +921,15 @@ namespace casadi {
     /** Obtain information about function */
     Dict info() const;
 
+    /** \brief Estimate the memory used by the function, in bytes
+
+        Returns a nested dictionary with the bytes used by e.g. the instruction
+        tape, constants, expression graph nodes, work vectors of all memory
+        objects, cached derivatives and dependency functions. Each level has
+        an entry "total".
+    */
+    Dict memory_footprint() const;
+
 #ifndef SWIG
     protected:
     ///@{
@@ -953,6 +972,58 @@ namespace casadi {
 
   };
 
+#if !defined(SWIG) || defined(SWIGPYTHON)
+  /** \brief Class to achieve minimal overhead function evaluations
+
+      Arguments and results are pointers to user-owned memory, e.g. NumPy arrays,
+      holding the nonzeros in column-major order. No copies are made: the memory
+      must stay valid for as long as it is set in the buffer.
+      Each buffer checks out its own memory object of the function, so that
+      different buffers can be evaluated from different threads.
+  */
+  class CASADI_EXPORT FunctionBuffer {
+    Function f_;
+    std::vector<double> w_;
+    std::vector<casadi_int> iw_;
+    std::vector<const double*> arg_;
+    std::vector<double*> res_;
+    casadi_int mem_;
+    int ret_;
+  public:
+    /** \brief Main constructor */
+    FunctionBuffer(const Function& f);
+#ifndef SWIG
+    ~FunctionBuffer();
+    FunctionBuffer(const FunctionBuffer& f);
+    FunctionBuffer& operator=(const FunctionBuffer& f);
+#endif // SWIG
+
+    /** \brief Set input buffer for input i
+
+        The size is in bytes and must match the number of nonzeros of the input
+    */
+    void set_arg(casadi_int i, const double* a, casadi_int size);
+
+    /** \brief Set output buffer for output i
+
+        The size is in bytes and must match the number of nonzeros of the output
+    */
+    void set_res(casadi_int i, double* a, casadi_int size);
+
+    /** \brief Get last return value */
+    int ret() const { return ret_;}
+
+    /** \brief Evaluate */
+    void _eval();
+
+    /** \brief Pointer to this object, for use with _function_buffer_eval */
+    void* _self() { return this;}
+  };
+
+  /** \brief Evaluate a FunctionBuffer given as a raw pointer */
+  CASADI_EXPORT void _function_buffer_eval(void* raw);
+#endif // !defined(SWIG) || defined(SWIGPYTHON)
+
 } // namespace casadi
 
 #include "sx.hpp"
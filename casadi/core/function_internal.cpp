@@ -30,6 +30,8 @@
 #include "external.hpp"
 #include "finite_differences.hpp"
 #include "map.hpp"
+#include "timing.hpp"
+#include "perf_counters.hpp"
 
 #include <typeinfo>
 #include <cctype>
@@ -42,6 +44,12 @@
 using namespace std;
 
 namespace casadi {
+
+#ifdef CASADI_WITH_THREAD
+  // Serializes the generation of cached functions, see FunctionInternal::incache
+  std::recursive_mutex mutex_generation;
+#endif //CASADI_WITH_THREAD
+
   Dict combine(const Dict& first, const Dict& second) {
     if (first.empty()) return second;
     if (second.empty()) return first;
@@ -79,6 +87,7 @@ namespace casadi {
     inputs_check_ = true;
     jit_ = false;
     compilerplugin_ = "clang";
+    jit_pgo_speedup_ = 0;
     print_time_ = true;
     eval_ = nullptr;
     has_refcount_ = false;
@@ -116,6 +125,9 @@ namespace casadi {
     // Make sure all options exist
     get_options().check(opts);
 
+    // Time initialization and finalization
+    PerfCounters::Timer timer(PerfCounters::FUNCTION_CONSTRUCT);
+
     // Initialize the class hierarchy
     try {
       init(opts);
@@ -196,6 +208,11 @@ namespace casadi {
       {"jit_options",
        {OT_DICT,
         "Options to be passed to the jit compiler."}},
+      {"jit_pgo_inputs",
+       {OT_DOUBLEVECTORVECTOR,
+        "Representative inputs, each holding the nonzeros of all inputs, used for "
+        "profile-guided optimization of the JIT'ed code. The faster of the regular "
+        "and the optimized build is kept. Requires the 'shell' compiler."}},
       {"derivative_of",
        {OT_FUNCTION,
         "The function is a derivative of another function. "
@@ -273,6 +290,8 @@ namespace casadi {
         compilerplugin_ = op.second.to_string();
       } else if (op.first=="jit_options") {
         jit_options_ = op.second;
+      } else if (op.first=="jit_pgo_inputs") {
+        jit_pgo_inputs_ = op.second;
       } else if (op.first=="derivative_of") {
         derivative_of_ = op.second;
       } else if (op.first=="ad_weight") {
@@ -376,16 +395,20 @@ namespace casadi {
     if (jit_) {
       string jit_name = "jit_tmp";
       if (has_codegen()) {
+        PerfCounters::Timer timer(PerfCounters::JIT_COMPILE);
         if (verbose_) casadi_message("Codegenerating function '" + name_ + "'.");
         // JIT everything
         CodeGenerator gen(jit_name);
         gen.add(self());
         if (verbose_) casadi_message("Compiling function '" + name_ + "'..");
-        compiler_ = Importer(gen.generate(), compilerplugin_, jit_options_);
+        string jit_file = gen.generate();
+        compiler_ = Importer(jit_file, compilerplugin_, jit_options_);
         if (verbose_) casadi_message("Compiling function '" + name_ + "' done.");
         // Try to load
         eval_ = (eval_t)compiler_.get_function(name_);
         casadi_assert(eval_!=nullptr, "Cannot load JIT'ed function.");
+        // Profile-guided optimization
+        if (!jit_pgo_inputs_.empty()) jit_pgo(jit_file);
       } else {
         // Just jit dependencies
         jit_dependencies(jit_name);
@@ -395,6 +418,83 @@ namespace casadi {
     ProtoFunction::finalize(opts);
   }
 
+  void FunctionInternal::jit_pgo(const std::string& fname) {
+    casadi_assert(compilerplugin_=="shell",
+      "Profile-guided optimization requires the 'shell' compiler");
+    for (auto&& x : jit_pgo_inputs_) {
+      casadi_assert(x.size()==nnz_in(),
+        "Representative input has " + str(x.size()) + " entries, expected " + str(nnz_in()));
+    }
+
+    // Number of repetitions to get a meaningful timing
+    double t = jit_pgo_eval(1);
+    casadi_int n_rep = t>0 ? std::max(casadi_int(1), static_cast<casadi_int>(0.05/t)) : 100;
+    double t_regular = jit_pgo_eval(n_rep);
+
+    // Instrumented build, collect the profile
+    if (verbose_) casadi_message("Collecting profile for function '" + name_ + "'.");
+    Dict opts = jit_options_;
+    opts["pgo"] = true;
+    Importer compiler(fname, compilerplugin_, opts);
+    eval_ = (eval_t)compiler.get_function(name_);
+    casadi_assert(eval_!=nullptr, "Cannot load instrumented function.");
+    jit_pgo_eval(n_rep);
+
+    // Rebuild using the profile
+    compiler.use_profile();
+    eval_ = (eval_t)compiler.get_function(name_);
+    casadi_assert(eval_!=nullptr, "Cannot load profile-optimized function.");
+    double t_pgo = jit_pgo_eval(n_rep);
+    jit_pgo_speedup_ = t_pgo>0 ? t_regular/t_pgo : 1;
+    if (verbose_) {
+      casadi_message("Profile-guided optimization of '" + name_ + "': speedup "
+                     + str(jit_pgo_speedup_));
+    }
+
+    // Keep the faster build
+    if (t_pgo<t_regular) {
+      compiler_ = compiler;
+    } else {
+      eval_ = (eval_t)compiler_.get_function(name_);
+    }
+  }
+
+  double FunctionInternal::jit_pgo_eval(casadi_int n_rep) const {
+    // Work vectors
+    vector<const double*> arg(sz_arg());
+    vector<double*> res(sz_res());
+    vector<casadi_int> iw(sz_iw());
+    vector<double> w(sz_w()), r(nnz_out());
+
+    FStats fstats;
+    fstats.tic();
+    for (casadi_int k=0; k<n_rep; ++k) {
+      for (auto&& x : jit_pgo_inputs_) {
+        const double* x_ptr = get_ptr(x);
+        for (casadi_int i=0; i<n_in_; ++i) {
+          arg[i] = x_ptr;
+          x_ptr += nnz_in(i);
+        }
+        double* r_ptr = get_ptr(r);
+        for (casadi_int i=0; i<n_out_; ++i) {
+          res[i] = r_ptr;
+          r_ptr += nnz_out(i);
+        }
+        if (eval_(get_ptr(arg), get_ptr(res), get_ptr(iw), get_ptr(w), nullptr)) {
+          casadi_error("Evaluation of JIT'ed function '" + name_ + "' failed");
+        }
+      }
+    }
+    fstats.toc();
+    return fstats.t_wall;
+  }
+
+  Dict FunctionInternal::get_stats(void* mem) const {
+    Dict stats;
+    if (jit_pgo_speedup_>0) stats["jit_pgo_speedup"] = jit_pgo_speedup_;
+    return stats;
+  }
+
   void ProtoFunction::finalize(const Dict& opts) {
     // Create memory object
     casadi_int mem = checkout();
@@ -463,19 +563,50 @@ namespace casadi {
     }
   }
 
-  bool FunctionInternal::incache(const std::string& fname, Function& f) const {
-    auto it = cache_.find(fname);
-    if (it!=cache_.end() && it->second.alive()) {
-      f = shared_cast<Function>(it->second.shared());
-      return true;
-    } else {
-      return false;
+  FunctionInternal::GenerationLock::~GenerationLock() {
+#ifdef CASADI_WITH_THREAD
+    if (locked_) mutex_generation.unlock();
+#endif //CASADI_WITH_THREAD
+  }
+
+  void FunctionInternal::GenerationLock::lock() {
+#ifdef CASADI_WITH_THREAD
+    if (!locked_) {
+      mutex_generation.lock();
+      locked_ = true;
+    }
+#endif //CASADI_WITH_THREAD
+  }
+
+  bool FunctionInternal::incache(const std::string& fname, Function& f,
+                                 GenerationLock& lock) const {
+    // Look up, the weak reference may be dead
+    auto lookup = [&]() {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> cache_lock(cache_mtx_);
+#endif //CASADI_WITH_THREAD
+      auto it = cache_.find(fname);
+      if (it!=cache_.end()) f = shared_cast<Function>(it->second.shared());
+      return !f.is_null();
+    };
+    bool hit = lookup();
+#ifdef CASADI_WITH_THREAD
+    // Wait for a generation in progress in another thread, then check again
+    if (!hit) {
+      lock.lock();
+      hit = lookup();
     }
+#endif //CASADI_WITH_THREAD
+    PerfCounters::count(hit ? PerfCounters::CACHE_HIT : PerfCounters::CACHE_MISS);
+    return hit;
   }
 
   void FunctionInternal::tocache(const Function& f) const {
-    // Add to cache
-    cache_.insert(make_pair(f.name(), f));
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> cache_lock(cache_mtx_);
+#endif //CASADI_WITH_THREAD
+    // Add to cache, replacing any lost reference with the same name
+    cache_[f.name()] = f;
     // Remove a lost reference, if any, to prevent uncontrolled growth
     for (auto it = cache_.begin(); it!=cache_.end(); ++it) {
       if (!it->second.alive()) {
@@ -490,7 +621,8 @@ namespace casadi {
     if (parallelization=="serial") {
       // Serial maps are cached
       string fname = "map" + str(n) + "_" + name_;
-      if (!incache(fname, f)) {
+      GenerationLock lock;
+      if (!incache(fname, f, lock)) {
         // Create new serial map
         f = Map::create(parallelization, self(), n);
         casadi_assert_dev(f.name()==fname);
@@ -507,7 +639,8 @@ namespace casadi {
   Function FunctionInternal::wrap() const {
     Function f;
     string fname = "wrap_" + name_;
-    if (!incache(fname, f)) {
+    GenerationLock lock;
+    if (!incache(fname, f, lock)) {
       // Options
       Dict opts;
       opts["derivative_of"] = derivative_of_;
@@ -1260,6 +1393,10 @@ namespace casadi {
 
   Sparsity& FunctionInternal::
   sparsity_jac(casadi_int iind, casadi_int oind, bool compact, bool symmetric) const {
+    // The blocks are generated on first use
+    GenerationLock lock;
+    lock.lock();
+
     // Get an owning reference to the block
     Sparsity jsp = compact ? jac_sparsity_compact_.elem(oind, iind)
         : jac_sparsity_.elem(oind, iind);
@@ -1434,7 +1571,8 @@ namespace casadi {
     // Retrieve/generate cached
     Function f;
     string fname = "fwd" + str(nfwd) + "_" + name_;
-    if (!incache(fname, f)) {
+    GenerationLock lock;
+    if (!incache(fname, f, lock)) {
       casadi_int i;
       // Names of inputs
       std::vector<std::string> inames;
@@ -1493,7 +1631,8 @@ namespace casadi {
     // Retrieve/generate cached
     Function f;
     string fname = "adj" + str(nadj) + "_" + name_;
-    if (!incache(fname, f)) {
+    GenerationLock lock;
+    if (!incache(fname, f, lock)) {
       casadi_int i;
       // Names of inputs
       std::vector<std::string> inames;
@@ -1665,7 +1804,8 @@ namespace casadi {
     // Retrieve/generate cached
     Function f;
     string fname = "JAC_" + name_;
-    if (!incache(fname, f)) {
+    GenerationLock lock;
+    if (!incache(fname, f, lock)) {
       // Names of inputs
       std::vector<std::string> inames = name_in_;
       inames.insert(inames.end(), name_out_.begin(), name_out_.end());
@@ -1707,12 +1847,10 @@ namespace casadi {
     }
 
     // Quick return if cached
-    if (jacobian_.alive()) {
-      return shared_cast<Function>(jacobian_.shared());
-    }
-
-    // Give it a suitable name
     string name = "jac_" + name_;
+    Function ret;
+    GenerationLock lock;
+    if (incache(name, ret, lock)) return ret;
 
     // Names of inputs
     std::vector<std::string> inames;
@@ -1728,14 +1866,14 @@ namespace casadi {
 
     // Generate derivative function
     casadi_assert_dev(enable_jacobian_);
-    Function ret = get_jacobian(name, inames, onames, opts);
+    ret = get_jacobian(name, inames, onames, opts);
 
     // Consistency check
     casadi_assert_dev(ret.n_in()==n_in_ + n_out_);
     casadi_assert_dev(ret.n_out()==1);
 
     // Cache it for reuse and return
-    jacobian_ = ret;
+    tocache(ret);
     return ret;
   }
 
@@ -1747,6 +1885,39 @@ namespace casadi {
     casadi_error("'get_jacobian' not defined for " + class_name());
   }
 
+  Function FunctionInternal::value_jacobian() const {
+    casadi_assert(has_value_jacobian(), "'value_jacobian' not defined for " + class_name());
+    Function f;
+    string fname = "val_jac_" + name_;
+    GenerationLock lock;
+    if (!incache(fname, f, lock)) {
+      // Names of inputs
+      std::vector<std::string> inames = name_in_;
+      // Names of outputs
+      std::vector<std::string> onames = name_out_;
+      onames.push_back("jac");
+      // Options
+      Dict opts;
+      opts["derivative_of"] = self();
+      // Generate the function
+      f = get_value_jacobian(fname, inames, onames, opts);
+      // Consistency check
+      casadi_assert_dev(f.n_in()==n_in_);
+      casadi_assert_dev(f.n_out()==n_out_+1);
+      // Save to cache
+      tocache(f);
+    }
+    return f;
+  }
+
+  Function FunctionInternal::
+  get_value_jacobian(const std::string& name,
+                     const std::vector<std::string>& inames,
+                     const std::vector<std::string>& onames,
+                     const Dict& opts) const {
+    casadi_error("'get_value_jacobian' not defined for " + class_name());
+  }
+
   Function FunctionInternal::
   get_jac(const std::string& name,
                const std::vector<std::string>& inames,
@@ -2186,6 +2357,75 @@ namespace casadi {
     return Dict();
   }
 
+  void ProtoFunction::add_footprint(Dict& fp, const std::string& key, size_t bytes) {
+    fp[key] = static_cast<casadi_int>(bytes);
+    casadi_int total = fp.find("total")==fp.end() ? 0 : fp["total"].as_int();
+    fp["total"] = total + static_cast<casadi_int>(bytes);
+  }
+
+  void ProtoFunction::add_footprint(Dict& fp, const std::string& key, const Dict& sub) {
+    casadi_int total = fp.find("total")==fp.end() ? 0 : fp["total"].as_int();
+    fp["total"] = total + sub.at("total").as_int();
+    fp[key] = sub;
+  }
+
+  Dict ProtoFunction::memory_footprint() const {
+    Dict fp;
+    fp["class"] = class_name();
+    size_t n_mem, mem = 0;
+    {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(mtx_);
+#endif //CASADI_WITH_THREAD
+      n_mem = mem_.size();
+      for (void* m : mem_) {
+        if (m!=nullptr) mem += mem_footprint(m);
+      }
+    }
+    fp["n_mem"] = static_cast<casadi_int>(n_mem);
+    add_footprint(fp, "memory", mem);
+    return fp;
+  }
+
+  Dict FunctionInternal::memory_footprint() const {
+    Dict fp = ProtoFunction::memory_footprint();
+
+    // Work vectors, one set for each memory object
+    size_t work = (sz_arg() + sz_res())*sizeof(double*)
+      + sz_iw()*sizeof(casadi_int) + sz_w()*sizeof(double);
+    add_footprint(fp, "work", work*fp.at("n_mem").as_int());
+
+    // Input and output sparsity patterns
+    size_t sp = 0;
+    for (auto&& s : sparsity_in_) sp += (2 + s.size2() + 1 + s.nnz())*sizeof(casadi_int);
+    for (auto&& s : sparsity_out_) sp += (2 + s.size2() + 1 + s.nnz())*sizeof(casadi_int);
+    add_footprint(fp, "sparsity", sp);
+
+    // Cached functions that are still alive
+    std::vector<Function> cached;
+    {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> cache_lock(cache_mtx_);
+#endif //CASADI_WITH_THREAD
+      for (auto&& c : cache_) {
+        Function f = shared_cast<Function>(c.second.shared());
+        if (!f.is_null()) cached.push_back(f);
+      }
+    }
+    Dict cache;
+    for (auto&& f : cached) add_footprint(cache, f.name(), f->memory_footprint());
+    if (!cache.empty()) add_footprint(fp, "cache", cache);
+
+    // Dependency functions
+    Dict fcn;
+    for (auto&& n : get_function()) {
+      const Function& f = get_function(n);
+      if (!f.is_null()) add_footprint(fcn, n, f->memory_footprint());
+    }
+    if (!fcn.empty()) add_footprint(fp, "functions", fcn);
+    return fp;
+  }
+
   void FunctionInternal::
   call_forward(const std::vector<MX>& arg, const std::vector<MX>& res,
              const std::vector<std::vector<MX> >& fseed,
@@ -2625,6 +2865,9 @@ namespace casadi {
       if (name_ == "jac_" + n) {
         return derivative_of_.n_in() + derivative_of_.n_out();
       }
+      if (name_ == "val_jac_" + n) {
+        return derivative_of_.n_in();
+      }
     }
     // One by default
     return 1;
@@ -2636,6 +2879,9 @@ namespace casadi {
       if (name_ == "jac_" + n) {
         return 1;
       }
+      if (name_ == "val_jac_" + n) {
+        return derivative_of_.n_out() + 1;
+      }
     }
     // One by default
     return 1;
@@ -2653,6 +2899,10 @@ namespace casadi {
           return Sparsity(derivative_of_.size_out(i-derivative_of_.n_in()));
         }
       }
+      if (name_ == "val_jac_" + n) {
+        // Same as nondifferentiated function
+        return derivative_of_.sparsity_in(i);
+      }
     }
     // Scalar by default
     return Sparsity::scalar();
@@ -2665,6 +2915,15 @@ namespace casadi {
         // Dense Jacobian by default
         return Sparsity::dense(derivative_of_.nnz_out(), derivative_of_.nnz_in());
       }
+      if (name_ == "val_jac_" + n) {
+        if (i < derivative_of_.n_out()) {
+          // Same as nondifferentiated function
+          return derivative_of_.sparsity_out(i);
+        } else {
+          // Dense Jacobian by default
+          return Sparsity::dense(derivative_of_.nnz_out(), derivative_of_.nnz_in());
+        }
+      }
     }
     // Scalar by default
     return Sparsity::scalar();
@@ -2681,8 +2940,10 @@ namespace casadi {
 #ifdef CASADI_WITH_THREAD
     std::lock_guard<std::mutex> lock(mtx_);
 #endif //CASADI_WITH_THREAD
+    PerfCounters::count(PerfCounters::CHECKOUT);
     if (unused_.empty()) {
       // Allocate a new memory object
+      PerfCounters::count(PerfCounters::CHECKOUT_ALLOC);
       void* m = alloc_mem();
       mem_.push_back(m);
       if (init_mem(m)) {
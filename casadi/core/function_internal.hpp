@@ -120,6 +120,20 @@ namespace casadi {
     /** \brief Clear all memory (called from destructor) */
     void clear_mem();
 
+    /** \brief Bytes allocated by a memory block, beyond the block itself */
+    virtual size_t mem_footprint(void* mem) const { return 0;}
+
+    /** \brief Estimate the memory used, in bytes
+
+        Returns a nested dictionary with an entry "total" at each level.
+        Functions referenced by several owners are counted for each owner.
+    */
+    virtual Dict memory_footprint() const;
+
+    /// Add an entry to a memory footprint, updating its total
+    static void add_footprint(Dict& fp, const std::string& key, size_t bytes);
+    static void add_footprint(Dict& fp, const std::string& key, const Dict& sub);
+
   protected:
     /// Name
     std::string name_;
@@ -322,6 +336,16 @@ namespace casadi {
                                   const Dict& opts) const;
     ///@}
 
+    ///@{
+    /** \brief Return the outputs together with the Jacobian, sharing work between them */
+    Function value_jacobian() const;
+    virtual bool has_value_jacobian() const { return false;}
+    virtual Function get_value_jacobian(const std::string& name,
+                                        const std::vector<std::string>& inames,
+                                        const std::vector<std::string>& onames,
+                                        const Dict& opts) const;
+    ///@}
+
     ///@{
     /** \brief Return Jacobian of all input elements with respect to all output elements */
     Function jac() const;
@@ -428,8 +452,37 @@ namespace casadi {
     /** \brief Wrap in an Function instance consisting of only one MX call */
     Function wrap() const;
 
-    /** \brief Get function in cache */
-    bool incache(const std::string& fname, Function& f) const;
+    /** \brief Exclusive right to generate cached functions, see incache
+
+        Also protects other state shared between threads during construction:
+        the Jacobian sparsity blocks and the plugin registry. The lock is
+        recursive and a no-op without thread support.
+
+        The lock is process-wide, not per function: the generation of
+        derivatives, Jacobian sparsity patterns and factory functions is
+        serialized across all functions. This is needed since expression
+        graphs can be shared between functions, and sorting a graph writes to
+        its nodes. Numerical evaluation does not take the lock and runs in
+        parallel.
+    */
+    class CASADI_EXPORT GenerationLock {
+    public:
+      GenerationLock() : locked_(false) {}
+      ~GenerationLock();
+      /// Wait for any generation in progress in another thread
+      void lock();
+    private:
+      bool locked_;
+    };
+
+    /** \brief Get function in cache
+
+        On a miss, the generation lock is acquired and the cache is checked
+        again, so that concurrent requests for the same function wait for a
+        single generation. The lock is held until it goes out of scope, i.e.
+        until the generated function has been added with tocache.
+    */
+    bool incache(const std::string& fname, Function& f, GenerationLock& lock) const;
 
     /** \brief Save function to cache */
     void tocache(const Function& f) const;
@@ -470,6 +523,12 @@ namespace casadi {
     /** \brief Jit dependencies */
     virtual void jit_dependencies(const std::string& fname) {}
 
+    /** \brief Rebuild the JIT'ed code using a profile of representative inputs */
+    void jit_pgo(const std::string& fname);
+
+    /** \brief Evaluate the JIT'ed code for the representative inputs, returns wall time */
+    double jit_pgo_eval(casadi_int n_rep) const;
+
     /** \brief Export function in a specific language */
     virtual void export_code(const std::string& lang,
       std::ostream &stream, const Dict& options) const;
@@ -683,7 +742,7 @@ namespace casadi {
     void alloc(const Function& f, bool persistent=false);
 
     /// Get all statistics
-    virtual Dict get_stats(void* mem) const { return Dict();}
+    virtual Dict get_stats(void* mem) const;
 
     /** \brief Set the (persistent) work vectors */
     virtual void set_work(void* mem, const double**& arg, double**& res,
@@ -705,6 +764,9 @@ namespace casadi {
     /** Obtain information about function */
     virtual Dict info() const;
 
+    /** \brief Estimate the memory used, in bytes */
+    Dict memory_footprint() const override;
+
     /** \brief Generate/retrieve cached serial map */
     Function map(casadi_int n, const std::string& parallelization) const;
 
@@ -732,8 +794,10 @@ namespace casadi {
     /// Function cache
     mutable std::map<std::string, WeakRef> cache_;
 
-    /// Cache for full Jacobian
-    mutable WeakRef jacobian_;
+#ifdef CASADI_WITH_THREAD
+    /// Protects cache_
+    mutable std::mutex cache_mtx_;
+#endif // CASADI_WITH_THREAD
 
     /// Cache for sparsities of the Jacobian blocks
     mutable SparseStorage<Sparsity> jac_sparsity_, jac_sparsity_compact_;
@@ -749,6 +813,12 @@ namespace casadi {
     Importer compiler_;
     Dict jit_options_;
 
+    /// Representative inputs for profile-guided optimization of the JIT'ed code
+    std::vector<std::vector<double> > jit_pgo_inputs_;
+
+    /// Observed speedup from profile-guided optimization
+    double jit_pgo_speedup_;
+
     /// Penalty factor for using a complete Jacobian to calculate directional derivatives
     double jac_penalty_;
 
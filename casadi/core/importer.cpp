@@ -81,6 +81,10 @@ namespace casadi {
     return (*this)->get_function(symname);
   }
 
+  void Importer::use_profile() {
+    (*this)->use_profile();
+  }
+
   bool Importer::has_meta(const std::string& cmd, casadi_int ind) const {
     return (*this)->has_meta(cmd, ind);
   }
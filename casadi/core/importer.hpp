@@ -116,6 +116,13 @@ namespace casadi {
     signal_t get_function(const std::string& symname);
 #endif // SWIG
 
+    /** \brief Rebuild using profile data from previous evaluations
+     *
+     * Requires an instrumented build, e.g. the 'pgo' option of the shell compiler.
+     * Function pointers obtained before the call are invalidated.
+     */
+    void use_profile();
+
     /** \brief Does a meta entry exist? */
     bool has_meta(const std::string& cmd, casadi_int ind=-1) const;
 
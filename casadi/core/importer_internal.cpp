@@ -212,6 +212,10 @@ namespace casadi {
     return const_cast<ImporterInternal*>(this)->get_function(symname)!=nullptr;
   }
 
+  void ImporterInternal::use_profile() {
+    casadi_error("'use_profile' not defined for " + class_name());
+  }
+
   DllLibrary::DllLibrary(const std::string& bin_name)
     : ImporterInternal(bin_name), handle_(nullptr) {
 #ifdef WITH_DL
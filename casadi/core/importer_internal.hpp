@@ -92,6 +92,9 @@ namespace casadi {
     /// Get a function pointer for numerical evaluation
     virtual signal_t get_function(const std::string& symname) { return nullptr;}
 
+    /// Rebuild using profile data from previous evaluations
+    virtual void use_profile();
+
     /// Get a function pointer for numerical evaluation
     bool has_function(const std::string& symname) const;
 
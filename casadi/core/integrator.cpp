@@ -1060,38 +1060,60 @@ namespace casadi {
     // Get discrete time dimensions
     nZ_ = F_.nnz_in(DAE_Z);
     nRZ_ =  G_.is_null() ? 0 : G_.nnz_in(RDAE_RZ);
+
+    // Allocate state, same order as in set_work
+    alloc_w(nx_ + nz_ + np_ + nq_, true); // x, z, p, q
+    alloc_w(nrx_ + nrz_ + nrp_ + nrq_, true); // rx, rz, rp, rq
+    alloc_w(nx_ + nZ_ + nq_, true); // x_prev, Z_prev, q_prev
+    alloc_w(nrx_ + nRZ_ + nrq_, true); // rx_prev, RZ_prev, rq_prev
+    alloc_w(nZ_ + nRZ_, true); // Z, RZ
+
+    // Allocate tape if backward states are present
+    if (nrx_>0) {
+      alloc_w((nk_+1)*nx_, true); // x_tape
+      alloc_w(nk_*nZ_, true); // Z_tape
+    }
   }
 
   int FixedStepIntegrator::init_mem(void* mem) const {
     if (Integrator::init_mem(mem)) return 1;
-    auto m = static_cast<FixedStepMemory*>(mem);
+    return 0;
+  }
 
-    // Discrete time algebraic variable
-    m->Z.resize(F_.nnz_in(DAE_Z));
-    if (!G_.is_null()) m->RZ.resize(G_.nnz_in(RDAE_RZ));
+  void FixedStepIntegrator::set_work(void* mem, const double**& arg, double**& res,
+                                     casadi_int*& iw, double*& w) const {
+    Integrator::set_work(mem, arg, res, iw, w);
+    auto m = static_cast<FixedStepMemory*>(mem);
 
-    // Allocate tape if backward states are present
+    // Current state
+    m->x = w; w += nx_;
+    m->z = w; w += nz_;
+    m->p = w; w += np_;
+    m->q = w; w += nq_;
+    m->rx = w; w += nrx_;
+    m->rz = w; w += nrz_;
+    m->rp = w; w += nrp_;
+    m->rq = w; w += nrq_;
+
+    // Previous state
+    m->x_prev = w; w += nx_;
+    m->Z_prev = w; w += nZ_;
+    m->q_prev = w; w += nq_;
+    m->rx_prev = w; w += nrx_;
+    m->RZ_prev = w; w += nRZ_;
+    m->rq_prev = w; w += nrq_;
+
+    // Algebraic variables for the discrete time integration
+    m->Z = w; w += nZ_;
+    m->RZ = w; w += nRZ_;
+
+    // Tape
     if (nrx_>0) {
-      m->x_tape.resize(nk_+1, vector<double>(nx_));
-      m->Z_tape.resize(nk_, vector<double>(nZ_));
+      m->x_tape = w; w += (nk_+1)*nx_;
+      m->Z_tape = w; w += nk_*nZ_;
+    } else {
+      m->x_tape = m->Z_tape = nullptr;
     }
-
-    // Allocate state
-    m->x.resize(nx_);
-    m->z.resize(nz_);
-    m->p.resize(np_);
-    m->q.resize(nq_);
-    m->rx.resize(nrx_);
-    m->rz.resize(nrz_);
-    m->rp.resize(nrp_);
-    m->rq.resize(nrq_);
-    m->x_prev.resize(nx_);
-    m->Z_prev.resize(nZ_);
-    m->q_prev.resize(nq_);
-    m->rx_prev.resize(nrx_);
-    m->RZ_prev.resize(nRZ_);
-    m->rq_prev.resize(nrq_);
-    return 0;
   }
 
   void FixedStepIntegrator::advance(IntegratorMemory* mem, double t,
@@ -1109,31 +1131,31 @@ namespace casadi {
     // Discrete dynamics function inputs ...
     fill_n(m->arg, F.n_in(), nullptr);
     m->arg[DAE_T] = &m->t;
-    m->arg[DAE_X] = get_ptr(m->x_prev);
-    m->arg[DAE_Z] = get_ptr(m->Z_prev);
-    m->arg[DAE_P] = get_ptr(m->p);
+    m->arg[DAE_X] = m->x_prev;
+    m->arg[DAE_Z] = m->Z_prev;
+    m->arg[DAE_P] = m->p;
 
     // ... and outputs
     fill_n(m->res, F.n_out(), nullptr);
-    m->res[DAE_ODE] = get_ptr(m->x);
-    m->res[DAE_ALG] = get_ptr(m->Z);
-    m->res[DAE_QUAD] = get_ptr(m->q);
+    m->res[DAE_ODE] = m->x;
+    m->res[DAE_ALG] = m->Z;
+    m->res[DAE_QUAD] = m->q;
 
     // Take time steps until end time has been reached
     while (m->k<k_out) {
       // Update the previous step
-      casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_prev));
-      casadi_copy(get_ptr(m->Z), nZ_, get_ptr(m->Z_prev));
-      casadi_copy(get_ptr(m->q), nq_, get_ptr(m->q_prev));
+      casadi_copy(m->x, nx_, m->x_prev);
+      casadi_copy(m->Z, nZ_, m->Z_prev);
+      casadi_copy(m->q, nq_, m->q_prev);
 
       // Take step
       F(m->arg, m->res, m->iw, m->w);
-      casadi_axpy(nq_, 1., get_ptr(m->q_prev), get_ptr(m->q));
+      casadi_axpy(nq_, 1., m->q_prev, m->q);
 
       // Tape
       if (nrx_>0) {
-        casadi_copy(get_ptr(m->x), nx_, get_ptr(m->x_tape.at(m->k+1)));
-        casadi_copy(get_ptr(m->Z), m->Z.size(), get_ptr(m->Z_tape.at(m->k)));
+        casadi_copy(m->x, nx_, m->x_tape + (m->k+1)*nx_);
+        casadi_copy(m->Z, nZ_, m->Z_tape + m->k*nZ_);
       }
 
       // Advance time
@@ -1142,9 +1164,9 @@ namespace casadi {
     }
 
     // Return to user TODO(@jaeandersson): interpolate
-    casadi_copy(get_ptr(m->x), nx_, x);
-    casadi_copy(get_ptr(m->Z)+m->Z.size()-nz_, nz_, z);
-    casadi_copy(get_ptr(m->q), nq_, q);
+    casadi_copy(m->x, nx_, x);
+    casadi_copy(m->Z+nZ_-nz_, nz_, z);
+    casadi_copy(m->q, nq_, q);
   }
 
   void FixedStepIntegrator::retreat(IntegratorMemory* mem, double t,
@@ -1163,16 +1185,16 @@ namespace casadi {
     // Discrete dynamics function inputs ...
     fill_n(m->arg, G.n_in(), nullptr);
     m->arg[RDAE_T] = &m->t;
-    m->arg[RDAE_P] = get_ptr(m->p);
-    m->arg[RDAE_RX] = get_ptr(m->rx_prev);
-    m->arg[RDAE_RZ] = get_ptr(m->RZ_prev);
-    m->arg[RDAE_RP] = get_ptr(m->rp);
+    m->arg[RDAE_P] = m->p;
+    m->arg[RDAE_RX] = m->rx_prev;
+    m->arg[RDAE_RZ] = m->RZ_prev;
+    m->arg[RDAE_RP] = m->rp;
 
     // ... and outputs
     fill_n(m->res, G.n_out(), nullptr);
-    m->res[RDAE_ODE] = get_ptr(m->rx);
-    m->res[RDAE_ALG] = get_ptr(m->RZ);
-    m->res[RDAE_QUAD] = get_ptr(m->rq);
+    m->res[RDAE_ODE] = m->rx;
+    m->res[RDAE_ALG] = m->RZ;
+    m->res[RDAE_QUAD] = m->rq;
 
     // Take time steps until end time has been reached
     while (m->k>k_out) {
@@ -1181,21 +1203,21 @@ namespace casadi {
       m->t = static_cast<double>(grid_.front()) + static_cast<double>(m->k)*h_;
 
       // Update the previous step
-      casadi_copy(get_ptr(m->rx), nrx_, get_ptr(m->rx_prev));
-      casadi_copy(get_ptr(m->RZ), nRZ_, get_ptr(m->RZ_prev));
-      casadi_copy(get_ptr(m->rq), nrq_, get_ptr(m->rq_prev));
+      casadi_copy(m->rx, nrx_, m->rx_prev);
+      casadi_copy(m->RZ, nRZ_, m->RZ_prev);
+      casadi_copy(m->rq, nrq_, m->rq_prev);
 
       // Take step
-      m->arg[RDAE_X] = get_ptr(m->x_tape.at(m->k));
-      m->arg[RDAE_Z] = get_ptr(m->Z_tape.at(m->k));
+      m->arg[RDAE_X] = m->x_tape + m->k*nx_;
+      m->arg[RDAE_Z] = m->Z_tape + m->k*nZ_;
       G(m->arg, m->res, m->iw, m->w);
-      casadi_axpy(nrq_, 1., get_ptr(m->rq_prev), get_ptr(m->rq));
+      casadi_axpy(nrq_, 1., m->rq_prev, m->rq);
     }
 
     // Return to user TODO(@jaeandersson): interpolate
-    casadi_copy(get_ptr(m->rx), nrx_, rx);
-    casadi_copy(get_ptr(m->RZ)+m->RZ.size()-nrz_, nrz_, rz);
-    casadi_copy(get_ptr(m->rq), nrq_, rq);
+    casadi_copy(m->rx, nrx_, rx);
+    casadi_copy(m->RZ+nRZ_-nrz_, nrz_, rz);
+    casadi_copy(m->rq, nrq_, rq);
   }
 
   void FixedStepIntegrator::
@@ -1207,24 +1229,24 @@ namespace casadi {
     m->t = t;
 
     // Set parameters
-    casadi_copy(p, np_, get_ptr(m->p));
+    casadi_copy(p, np_, m->p);
 
     // Update the state
-    casadi_copy(x, nx_, get_ptr(m->x));
-    casadi_copy(z, nz_, get_ptr(m->z));
+    casadi_copy(x, nx_, m->x);
+    casadi_copy(z, nz_, m->z);
 
     // Reset summation states
-    casadi_fill(get_ptr(m->q), nq_, 0.);
+    casadi_fill(m->q, nq_, 0.);
 
     // Bring discrete time to the beginning
     m->k = 0;
 
     // Get consistent initial conditions
-    casadi_fill(get_ptr(m->Z), m->Z.size(), numeric_limits<double>::quiet_NaN());
+    casadi_fill(m->Z, nZ_, numeric_limits<double>::quiet_NaN());
 
     // Add the first element in the tape
     if (nrx_>0) {
-      casadi_copy(x, nx_, get_ptr(m->x_tape.at(0)));
+      casadi_copy(x, nx_, m->x_tape);
     }
   }
 
@@ -1236,20 +1258,164 @@ namespace casadi {
     m->t = t;
 
     // Set parameters
-    casadi_copy(rp, nrp_, get_ptr(m->rp));
+    casadi_copy(rp, nrp_, m->rp);
 
     // Update the state
-    casadi_copy(rx, nrx_, get_ptr(m->rx));
-    casadi_copy(rz, nrz_, get_ptr(m->rz));
+    casadi_copy(rx, nrx_, m->rx);
+    casadi_copy(rz, nrz_, m->rz);
 
     // Reset summation states
-    casadi_fill(get_ptr(m->rq), nrq_, 0.);
+    casadi_fill(m->rq, nrq_, 0.);
 
     // Bring discrete time to the end
     m->k = nk_;
 
     // Get consistent initial conditions
-    casadi_fill(get_ptr(m->RZ), m->RZ.size(), numeric_limits<double>::quiet_NaN());
+    casadi_fill(m->RZ, nRZ_, numeric_limits<double>::quiet_NaN());
+  }
+
+  bool FixedStepIntegrator::has_codegen() const {
+    if (!getExplicit()->has_codegen()) return false;
+    if (nrx_>0 && !getExplicitB()->has_codegen()) return false;
+    return true;
+  }
+
+  void FixedStepIntegrator::codegen_declarations(CodeGenerator& g) const {
+    g.add_dependency(getExplicit());
+    if (nrx_>0) g.add_dependency(getExplicitB());
+  }
+
+  void FixedStepIntegrator::codegen_reset(CodeGenerator& g) const {
+    g << g.copy("arg[" + str(INTEGRATOR_P) + "]", np_, "p") << "\n";
+    g << g.copy("arg[" + str(INTEGRATOR_X0) + "]", nx_, "x") << "\n";
+    g << g.fill("q", nq_, "0.") << "\n";
+    g << "k = 0;\n";
+    // Overwritten before use, zero rather than NaN for C89 compatibility
+    g << g.fill("Z", nZ_, "0.") << "\n";
+    if (nrx_>0) g << g.copy("x", nx_, "x_tape") << "\n";
+  }
+
+  void FixedStepIntegrator::codegen_resetB(CodeGenerator& g) const {
+    g << g.copy("arg[" + str(INTEGRATOR_RP) + "]", nrp_, "rp") << "\n";
+    g << g.copy("arg[" + str(INTEGRATOR_RX0) + "]", nrx_, "rx") << "\n";
+    g << g.fill("rq", nrq_, "0.") << "\n";
+    g << "k = " << nk_ << ";\n";
+    g << g.fill("RZ", nRZ_, "0.") << "\n";
+  }
+
+  void FixedStepIntegrator::codegen_body(CodeGenerator& g) const {
+    // Work vectors, same order as in set_work. Unused entries are skipped.
+    auto work = [&](const std::string& v, casadi_int n, bool used) {
+      if (used) {
+        g.local(v, "casadi_real", "*");
+        g << v << " = w; ";
+      }
+      g << "w += " << n << ";\n";
+    };
+    bool bwd = nrx_>0;
+    work("x", nx_, true);
+    work("z", nz_, false);
+    work("p", np_, true);
+    work("q", nq_, true);
+    work("rx", nrx_, bwd);
+    work("rz", nrz_, false);
+    work("rp", nrp_, bwd);
+    work("rq", nrq_, bwd);
+    work("x_prev", nx_, true);
+    work("Z_prev", nZ_, true);
+    work("q_prev", nq_, true);
+    work("rx_prev", nrx_, bwd);
+    work("RZ_prev", nRZ_, bwd);
+    work("rq_prev", nrq_, bwd);
+    work("Z", nZ_, true);
+    work("RZ", nRZ_, bwd);
+    if (bwd) {
+      work("x_tape", (nk_+1)*nx_, true);
+      work("Z_tape", nk_*nZ_, true);
+    }
+    g.local("t", "casadi_real");
+    g.local("k", "casadi_int");
+    g.local("j", "casadi_int");
+
+    // Arguments and results of the called functions
+    std::string arg1 = "arg+" + str(n_in_), res1 = "res+" + str(n_out_);
+    std::string a = "arg[" + str(n_in_), r = "res[" + str(n_out_);
+
+    // Discrete time at each output time, cf. advance
+    std::vector<casadi_int> k_out;
+    for (casadi_int k=output_t0_ ? 0 : 1; k<grid_.size(); ++k) {
+      casadi_int kk = static_cast<casadi_int>(std::ceil((grid_[k] - grid_.front())/h_));
+      k_out.push_back(std::min(kk, nk_));
+    }
+    std::string t_k = g.constant(grid_.front()) + "+k*" + g.constant(h_);
+
+    g.comment("Reset the forward problem");
+    codegen_reset(g);
+
+    g.comment("Integrate forward");
+    g << "for (j=0; j<" << ntout_ << "; ++j) {\n";
+    g << "for (; k<" << g.constant(k_out) << "[j]; ++k) {\n";
+    g.comment("Update the previous step");
+    g << "t = " << t_k << ";\n";
+    g << g.copy("x", nx_, "x_prev") << "\n";
+    g << g.copy("Z", nZ_, "Z_prev") << "\n";
+    g << g.copy("q", nq_, "q_prev") << "\n";
+    g.comment("Take step");
+    g << a << "+" << DAE_T << "] = &t;\n";
+    g << a << "+" << DAE_X << "] = x_prev;\n";
+    g << a << "+" << DAE_Z << "] = Z_prev;\n";
+    g << a << "+" << DAE_P << "] = p;\n";
+    g << r << "+" << DAE_ODE << "] = x;\n";
+    g << r << "+" << DAE_ALG << "] = Z;\n";
+    g << r << "+" << DAE_QUAD << "] = q;\n";
+    g << "if (" << g(getExplicit(), arg1, res1, "iw", "w", "0") << ") return 1;\n";
+    g << g.axpy(nq_, "1.", "q_prev", "q") << "\n";
+    if (bwd) {
+      g.comment("Tape");
+      g << g.copy("x", nx_, "x_tape+(k+1)*" + str(nx_)) << "\n";
+      g << g.copy("Z", nZ_, "Z_tape+k*" + str(nZ_)) << "\n";
+    }
+    g << "}\n";
+    g.comment("Return to user");
+    g << "if (res[" << INTEGRATOR_XF << "]) "
+      << g.copy("x", nx_, "res[" + str(INTEGRATOR_XF) + "]+j*" + str(nx_)) << "\n";
+    g << "if (res[" << INTEGRATOR_ZF << "]) "
+      << g.copy("Z+" + str(nZ_-nz_), nz_, "res[" + str(INTEGRATOR_ZF) + "]+j*" + str(nz_))
+      << "\n";
+    g << "if (res[" << INTEGRATOR_QF << "]) "
+      << g.copy("q", nq_, "res[" + str(INTEGRATOR_QF) + "]+j*" + str(nq_)) << "\n";
+    g << "}\n";
+
+    // Backward integration
+    if (bwd) {
+      g.comment("Reset the backward problem");
+      codegen_resetB(g);
+
+      g.comment("Integrate backward");
+      g << "while (k>0) {\n";
+      g << "k--;\n";
+      g << "t = " << t_k << ";\n";
+      g << g.copy("rx", nrx_, "rx_prev") << "\n";
+      g << g.copy("RZ", nRZ_, "RZ_prev") << "\n";
+      g << g.copy("rq", nrq_, "rq_prev") << "\n";
+      g << a << "+" << RDAE_T << "] = &t;\n";
+      g << a << "+" << RDAE_X << "] = x_tape+k*" << nx_ << ";\n";
+      g << a << "+" << RDAE_Z << "] = Z_tape+k*" << nZ_ << ";\n";
+      g << a << "+" << RDAE_P << "] = p;\n";
+      g << a << "+" << RDAE_RX << "] = rx_prev;\n";
+      g << a << "+" << RDAE_RZ << "] = RZ_prev;\n";
+      g << a << "+" << RDAE_RP << "] = rp;\n";
+      g << r << "+" << RDAE_ODE << "] = rx;\n";
+      g << r << "+" << RDAE_ALG << "] = RZ;\n";
+      g << r << "+" << RDAE_QUAD << "] = rq;\n";
+      g << "if (" << g(getExplicitB(), arg1, res1, "iw", "w", "0") << ") return 1;\n";
+      g << g.axpy(nrq_, "1.", "rq_prev", "rq") << "\n";
+      g << "}\n";
+      g.comment("Return to user");
+      g << g.copy("rx", nrx_, "res[" + str(INTEGRATOR_RXF) + "]") << "\n";
+      g << g.copy("RZ+" + str(nRZ_-nrz_), nrz_, "res[" + str(INTEGRATOR_RZF) + "]") << "\n";
+      g << g.copy("rq", nrq_, "res[" + str(INTEGRATOR_RQF) + "]") << "\n";
+    }
   }
 
   ImplicitFixedStepIntegrator::
@@ -228,16 +228,16 @@ namespace casadi {
     casadi_int k;
 
     // Current state
-    std::vector<double> x, z, p, q, rx, rz, rp, rq;
+    double *x, *z, *p, *q, *rx, *rz, *rp, *rq;
 
     // Previous state
-    std::vector<double> x_prev, Z_prev, q_prev, rx_prev, RZ_prev, rq_prev;
+    double *x_prev, *Z_prev, *q_prev, *rx_prev, *RZ_prev, *rq_prev;
 
     /// Algebraic variables for the discrete time integration
-    std::vector<double> Z, RZ;
+    double *Z, *RZ;
 
-    // Tape
-    std::vector<std::vector<double> > x_tape, Z_tape;
+    // Tape, stored column-wise for each finite element
+    double *x_tape, *Z_tape;
   };
 
   class CASADI_EXPORT FixedStepIntegrator : public Integrator {
@@ -267,6 +267,25 @@ namespace casadi {
     /** \brief Free memory block */
     void free_mem(void *mem) const override { delete static_cast<FixedStepMemory*>(mem);}
 
+    /** \brief Set the (persistent) work vectors */
+    void set_work(void* mem, const double**& arg, double**& res,
+                  casadi_int*& iw, double*& w) const override;
+
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override;
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the function body */
+    void codegen_body(CodeGenerator& g) const override;
+
+    /** \brief Generate code for resetting the forward problem */
+    virtual void codegen_reset(CodeGenerator& g) const;
+
+    /** \brief Generate code for resetting the backward problem */
+    virtual void codegen_resetB(CodeGenerator& g) const;
+
     /// Setup F and G
     virtual void setupFG() = 0;
 
@@ -25,6 +25,7 @@
 
 #include "linsol_internal.hpp"
 #include "mx_node.hpp"
+#include "perf_counters.hpp"
 
 using namespace std;
 namespace casadi {
@@ -126,6 +127,7 @@ namespace casadi {
     }
 
     m->is_nfact = false;
+    PerfCounters::Timer timer(PerfCounters::LINSOL_NFACT);
     if ((*this)->nfact(m, A)) return 1;
     m->is_nfact = true;
     return 0;
@@ -103,6 +103,9 @@ namespace casadi {
     /// Matrix rank
     virtual casadi_int rank(void* mem, const double* A) const;
 
+    /// Is code generation supported?
+    virtual bool has_codegen() const { return false;}
+
     /// Generate C code
     virtual void generate(CodeGenerator& g, const std::string& A, const std::string& x,
                           casadi_int nrhs, bool tr) const;
@@ -579,6 +579,64 @@ namespace casadi {
     }
   }
 
+  // Estimated number of multiplications in a sparse matrix product
+  static double mtimes_cost(const Sparsity& x, const Sparsity& y) {
+    // Nonzeros in each row of y
+    std::vector<casadi_int> y_rownnz(y.size1(), 0);
+    const casadi_int* y_row = y.row();
+    for (casadi_int k=0; k<y.nnz(); ++k) y_rownnz[y_row[k]]++;
+    // Each nonzero x(i, k) is multiplied with the nonzeros in row k of y
+    const casadi_int* x_colind = x.colind();
+    double ret = 0;
+    for (casadi_int k=0; k<x.size2(); ++k) {
+      ret += static_cast<double>(x_colind[k+1]-x_colind[k])*static_cast<double>(y_rownnz[k]);
+    }
+    return ret;
+  }
+
+  // Product of the subchain i..j, given the optimal splits
+  static MX mtimes_chain(const std::vector<MX>& args, const std::vector<casadi_int>& split,
+                         casadi_int i, casadi_int j) {
+    if (i==j) return args[i];
+    casadi_int k = split[i*args.size()+j];
+    return mtimes(mtimes_chain(args, split, i, k), mtimes_chain(args, split, k+1, j));
+  }
+
+  MX MX::mtimes(const std::vector<MX>& args) {
+    casadi_assert(args.size()>=1, "mtimes: supplied list must not be empty.");
+    casadi_int n = args.size();
+    // Multiply in the order written if there is nothing to choose or if the
+    // scalar factors make the dimensions inconsistent
+    bool reorder = n>2;
+    for (casadi_int i=0; i<n && reorder; ++i) {
+      if (args[i].is_scalar() || (i>0 && args[i-1].size2()!=args[i].size1())) reorder = false;
+    }
+    if (!reorder) return SparsityInterface<MX>::mtimes(args);
+    // Dynamic programming over subchains i..j, stored at i*n+j: sparsity
+    // pattern of the product, lowest cost and the corresponding split
+    std::vector<Sparsity> sp(n*n);
+    std::vector<double> cost(n*n, 0);
+    std::vector<casadi_int> split(n*n, -1);
+    for (casadi_int i=0; i<n; ++i) sp[i*n+i] = args[i].sparsity();
+    for (casadi_int len=2; len<=n; ++len) {
+      for (casadi_int i=0; i+len<=n; ++i) {
+        casadi_int j = i+len-1;
+        cost[i*n+j] = casadi::inf;
+        for (casadi_int k=i; k<j; ++k) {
+          double c = cost[i*n+k] + cost[(k+1)*n+j] + mtimes_cost(sp[i*n+k], sp[(k+1)*n+j]);
+          if (c<cost[i*n+j]) {
+            cost[i*n+j] = c;
+            split[i*n+j] = k;
+          }
+        }
+        // The pattern does not depend on the order
+        casadi_int k = split[i*n+j];
+        sp[i*n+j] = Sparsity::mtimes(sp[i*n+k], sp[(k+1)*n+j]);
+      }
+    }
+    return mtimes_chain(args, split, 0, n-1);
+  }
+
   MX MX::einstein(const MX& A, const MX& B, const MX& C,
       const std::vector<casadi_int>& dim_a, const std::vector<casadi_int>& dim_b,
       const std::vector<casadi_int>& dim_c,
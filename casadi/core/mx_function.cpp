@@ -28,9 +28,12 @@
 #include "global_options.hpp"
 #include "casadi_interrupt.hpp"
 #include "io_instruction.hpp"
+#include "casadi_call.hpp"
+#include "constant_mx.hpp"
 
 #include <stack>
 #include <typeinfo>
+#include <algorithm>
 
 // Throw informative error message
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
@@ -46,10 +49,12 @@ namespace casadi {
                          const std::vector<MX>& outputv,
                          const std::vector<std::string>& name_in,
                          const std::vector<std::string>& name_out) :
-    XFunction<MXFunction, MX, MXNode>(name, inputv, outputv, name_in, name_out) {
+    XFunction<MXFunction, MX, MXNode>(name, inputv, outputv, name_in, name_out),
+    reorder_mtimes_(false) {
   }
 
   MXFunction::~MXFunction() {
+    clear_mem();
   }
 
   Options MXFunction::options_
@@ -59,7 +64,35 @@ namespace casadi {
         "Default input values"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"inline_threshold",
+       {OT_INT,
+        "Inline calls to MX functions with at most this many instructions and "
+        "expand such calls to SX functions together with neighbouring cheap operations. "
+        "Negative value: never inline [-1]"}},
+      {"incremental",
+       {OT_BOOL,
+        "Keep the intermediate results in the memory object and only "
+        "re-execute the operations depending on inputs that changed "
+        "since the last evaluation. Disables live_variables. Evaluations "
+        "with a memory object in use, e.g. by another thread, recalculate "
+        "everything. The stats entry n_exec counts the operations executed."}},
+      {"fold_constants",
+       {OT_BOOL,
+        "Evaluate the subexpressions that only depend on constants once, "
+        "during initialization, and replace them by constants. If an operation in "
+        "a constant subexpression cannot be evaluated numerically, the original "
+        "graph is kept without notice [false]"}},
+      {"reorder_mtimes",
+       {OT_BOOL,
+        "Multiply chains of matrix products in the order with the lowest "
+        "estimated cost, taking sparsity into account. Inherited by the "
+        "derivative functions [false]"}},
+      {"fuse_value_jacobian",
+       {OT_BOOL,
+        "Replace calls to a function and to its Jacobian with the same arguments "
+        "by a single call to its value_jacobian function, where available. Applies "
+        "also to the functions generated by solvers and factories [true]"}}
      }
   };
 
@@ -87,6 +120,71 @@ namespace casadi {
     }
   }
 
+  /** \brief Calls to a function and its Jacobian with the same arguments
+   *
+   * Replaces both calls in the sorted list of nodes by a single call to the
+   * value_jacobian function, where available. The outputs of the replaced calls
+   * are redirected to the outputs of the new call.
+   */
+  static void fuse_value_jacobian(vector<MXNode*>& nodes, vector<MX>& fused,
+                                  map<const MXNode*, pair<MXNode*, casadi_int> >& redirect) {
+    // Calls, indexed by function and argument nodes
+    typedef pair<FunctionInternal*, vector<MXNode*> > CallKey;
+    map<CallKey, casadi_int> val_calls, jac_calls;
+    for (casadi_int k=0; k<nodes.size(); ++k) {
+      MXNode* n = nodes[k];
+      if (n->op()!=OP_CALL) continue;
+      const Function& fcn = n->which_function();
+      if (fcn->has_value_jacobian()) {
+        // Nondifferentiated function
+        vector<MXNode*> arg(fcn.n_in());
+        for (casadi_int i=0; i<arg.size(); ++i) arg[i] = n->dep(i).get();
+        val_calls.insert(make_pair(CallKey(fcn.get(), arg), k));
+      } else {
+        // Jacobian of a function, nondifferentiated outputs not needed for the key
+        const Function& f = fcn->derivative_of_;
+        if (f.is_null() || !f->has_value_jacobian()) continue;
+        if (f->jacobian().get()!=fcn.get()) continue;
+        vector<MXNode*> arg(f.n_in());
+        for (casadi_int i=0; i<arg.size(); ++i) arg[i] = n->dep(i).get();
+        jac_calls.insert(make_pair(CallKey(f.get(), arg), k));
+      }
+    }
+
+    // Replace matching pairs
+    bool erased = false;
+    for (auto&& j : jac_calls) {
+      auto it = val_calls.find(j.first);
+      if (it==val_calls.end()) continue;
+      MXNode* c = nodes[it->second];
+      MXNode* d = nodes[j.second];
+      Function fcn = c->which_function()->value_jacobian();
+      if (fcn.sparsity_out(fcn.n_out()-1)!=d->sparsity(0)) continue;
+      vector<MX> arg(c->n_dep());
+      for (casadi_int i=0; i<arg.size(); ++i) arg[i] = c->dep(i);
+      vector<MX> res = Call::create(fcn, arg);
+      // Jacobian block is dense, hence always a proper output node
+      casadi_assert_dev(res.back().is_output());
+      MX e_mx = res.back()->dep(0);
+      MXNode* e = e_mx.get();
+      // Arguments must not have been projected
+      bool same_arg = true;
+      for (casadi_int i=0; i<arg.size(); ++i) same_arg = same_arg && e->dep(i).get()==arg[i].get();
+      if (!same_arg) continue;
+      fused.push_back(e_mx);
+      // Outputs of the replaced calls, with offset in the outputs of the new call
+      redirect[c] = make_pair(e, 0);
+      redirect[d] = make_pair(e, fcn.n_out()-1);
+      // New call takes the place of the first of the calls, arguments come before both
+      nodes[min(it->second, j.second)] = e;
+      nodes[max(it->second, j.second)] = nullptr;
+      // Replaced calls are no longer in the list, mark as not visited
+      c->temp = d->temp = 0;
+      erased = true;
+    }
+    if (erased) nodes.erase(remove(nodes.begin(), nodes.end(), nullptr), nodes.end());
+  }
+
   void MXFunction::init(const Dict& opts) {
     // Call the init function of the base class
     XFunction<MXFunction, MX, MXNode>::init(opts);
@@ -94,6 +192,9 @@ namespace casadi {
 
     // Default (temporary) options
     bool live_variables = true;
+    casadi_int inline_threshold = -1;
+    bool fold_constants = false;
+    bool fuse = true;
 
     // Read options
     for (auto&& op : opts) {
@@ -101,9 +202,53 @@ namespace casadi {
         default_in_ = op.second;
       } else if (op.first=="live_variables") {
         live_variables = op.second;
+      } else if (op.first=="inline_threshold") {
+        inline_threshold = op.second;
+      } else if (op.first=="incremental") {
+        incremental_ = op.second;
+      } else if (op.first=="fold_constants") {
+        fold_constants = op.second;
+      } else if (op.first=="reorder_mtimes") {
+        reorder_mtimes_ = op.second;
+      } else if (op.first=="fuse_value_jacobian") {
+        fuse = op.second;
       }
     }
 
+    // Derivative graphs are reassociated if the original graph is
+    if (!derivative_of_.is_null() && derivative_of_.is_a("MXFunction")) {
+      if (static_cast<const MXFunction*>(derivative_of_.get())->reorder_mtimes_) {
+        reorder_mtimes_ = true;
+      }
+    }
+
+    // Intermediate results must not be overwritten in incremental evaluation
+    if (incremental_) live_variables = false;
+
+    // Inline calls to small functions before sorting the graph
+    if (inline_threshold>=0) {
+      Function tmp(name_, in_, out_, Dict{{"live_variables", false}});
+      out_ = static_cast<const MXFunction*>(tmp.get())->inline_calls(inline_threshold);
+    }
+
+    // Replace constant subexpressions by their values. Nodes that are no longer
+    // needed drop out when the graph is sorted below.
+    if (fold_constants) {
+      Function tmp(name_, in_, out_, Dict{{"live_variables", false}});
+      try {
+        out_ = static_cast<const MXFunction*>(tmp.get())->fold_constants();
+      } catch (std::exception& e) {
+        // Keep the original graph if some operation cannot be folded
+        if (verbose_) casadi_message(name_ + ": constant folding failed: " + e.what());
+      }
+    }
+
+    // Reassociate chains of matrix products
+    if (reorder_mtimes_) {
+      Function tmp(name_, in_, out_, Dict{{"live_variables", false}});
+      out_ = static_cast<const MXFunction*>(tmp.get())->reorder_mtimes();
+    }
+
     // Check/set default inputs
     if (default_in_.empty()) {
       default_in_.resize(n_in_, 0);
@@ -134,6 +279,14 @@ namespace casadi {
       }
     }
 
+    // Evaluate functions together with their Jacobians, where both are needed
+    vector<MX> fused;
+    std::map<const MXNode*, pair<MXNode*, casadi_int> > redirect;
+    if (fuse) fuse_value_jacobian(nodes, fused, redirect);
+    if (verbose_ && !fused.empty()) {
+      casadi_message(name_ + ": fused " + str(fused.size()) + " value/Jacobian call pairs");
+    }
+
     // Set the temporary variables to be the corresponding place in the sorted graph
     for (casadi_int i=0; i<nodes.size(); ++i) {
       nodes[i]->temp = i;
@@ -190,11 +343,19 @@ namespace casadi {
         algorithm_.push_back(ae);
 
       } else { // Function output node
-        // Get the output index
+        // Get the output index and the parent node
         casadi_int oind = n->which_output();
+        const MXNode* parent = n->dep(0).get();
+
+        // Parent node replaced by a fused call
+        auto it = redirect.find(parent);
+        if (it!=redirect.end()) {
+          parent = it->second.first;
+          oind += it->second.second;
+        }
 
         // Get the index of the parent node
-        casadi_int pind = place_in_alg[n->dep(0)->temp];
+        casadi_int pind = place_in_alg[parent->temp];
 
         // Save location in the algorithm element corresponding to the parent node
         casadi_int& otmp = algorithm_[pind].res.at(oind);
@@ -371,6 +532,49 @@ namespace casadi {
       }
     }
 
+    // Outputs depending on each operation result, found in a backward sweep over
+    // the algorithm. The demand of a work vector element is reset where it is assigned,
+    // since the element may be reused by the live variable algorithm.
+    res_dep_.clear();
+    if (n_out_>1) {
+      casadi_int n_res = 0;
+      for (auto&& e : algorithm_) n_res += e.res.size();
+      res_dep_.resize(n_res);
+      vector<uint64_t> demand(worksize, 0);
+      for (auto e = algorithm_.rbegin(); e != algorithm_.rend(); ++e) {
+        uint64_t dep = 0;
+        if (e->op==OP_OUTPUT) {
+          dep = mask_bit(e->data->ind());
+        } else if (e->res.empty()) {
+          // Always evaluated
+          dep = ~uint64_t(0);
+        } else {
+          n_res -= e->res.size();
+          for (casadi_int c=0; c<e->res.size(); ++c) {
+            if (e->res[c]>=0) {
+              res_dep_[n_res+c] = demand[e->res[c]];
+              demand[e->res[c]] = 0;
+              dep |= res_dep_[n_res+c];
+            }
+          }
+        }
+        for (casadi_int a : e->arg) if (a>=0) demand[a] |= dep;
+      }
+    }
+
+    // Inputs each operation depends on, found in a forward sweep over the algorithm
+    in_dep_.clear();
+    if (incremental_) {
+      in_dep_.resize(algorithm_.size());
+      vector<uint64_t> dep(worksize, 0);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        const AlgEl& e = algorithm_[k];
+        in_dep_[k] = e.op==OP_INPUT ? mask_bit(e.data->ind()) : 0;
+        for (casadi_int a : e.arg) if (a>=0) in_dep_[k] |= dep[a];
+        for (casadi_int r : e.res) if (r>=0) dep[r] = in_dep_[k];
+      }
+    }
+
     // Does any embedded function have reference counting for codegen?
     for (auto&& a : algorithm_) {
       if (a.data->has_refcount()) {
@@ -395,9 +599,41 @@ namespace casadi {
                    + str(free_vars_) + " are free.");
     }
 
+    // Incremental evaluation: only re-execute the operations depending on changed inputs,
+    // intermediate results are kept in the memory object
+    XFunctionMemoryLock lock(incremental_ ? mem : nullptr);
+    XFunctionMemory* m = lock.get();
+    uint64_t chg = 0;
+    const uint64_t* ind = get_ptr(in_dep_);
+    if (m) {
+      chg = changed_inputs(arg, m);
+      w = get_ptr(m->w);
+      m->n_exec = 0;
+    }
+
+    // After a failed or no previous call, also the operations not depending on any input
+    bool skip = m && chg!=~uint64_t(0);
+
+    // Only a subset of the outputs requested: skip the operations not needed
+    uint64_t req;
+    bool pruned = !m && prune(res, req);
+    if (pruned && !(req & demand_all_)) return 0;
+    const uint64_t* dep = get_ptr(res_dep_);
+
     // Evaluate all of the nodes of the algorithm:
     // should only evaluate nodes that have not yet been calculated!
     for (auto&& e : algorithm_) {
+      if (skip && !(*ind++ & chg) && e.op!=OP_OUTPUT) continue;
+      if (m) m->n_exec++;
+      if (pruned && !e.res.empty()) {
+        // Skip if none of the results is needed
+        bool needed = false;
+        for (casadi_int i=0; i<e.res.size() && !needed; ++i) needed = (dep[i] & req)!=0;
+        if (!needed) {
+          dep += e.res.size();
+          continue;
+        }
+      }
       if (e.op==OP_INPUT) {
         // Pass an input
         double *w1 = w+workloc_[e.res.front()];
@@ -420,13 +656,16 @@ namespace casadi {
         // Point pointers to the data corresponding to the element
         for (casadi_int i=0; i<e.arg.size(); ++i)
           arg1[i] = e.arg[i]>=0 ? w+workloc_[e.arg[i]] : nullptr;
-        for (casadi_int i=0; i<e.res.size(); ++i)
-          res1[i] = e.res[i]>=0 ? w+workloc_[e.res[i]] : nullptr;
+        for (casadi_int i=0; i<e.res.size(); ++i) {
+          res1[i] = e.res[i]>=0 && (!pruned || (dep[i] & req)) ? w+workloc_[e.res[i]] : nullptr;
+        }
 
         // Evaluate
         if (e.data->eval(arg1, res1, iw, w)) return 1;
       }
+      if (pruned) dep += e.res.size();
     }
+    if (m) m->valid = true;
     return 0;
   }
 
@@ -659,6 +898,399 @@ namespace casadi {
     }
   }
 
+  std::vector<MX> MXFunction::inline_calls(casadi_int threshold) const {
+    // Is a call small enough to be inlined (MX) or expanded (SX)?
+    auto small_call = [&](const AlgEl& e, const std::string& type) {
+      if (e.op!=OP_CALL) return false;
+      Function f = e.data.which_function();
+      return f.is_a(type) && !f.has_free() && f.n_instructions()<=threshold;
+    };
+    auto small_mx = [&](const AlgEl& e) { return small_call(e, "MXFunction");};
+    auto small_sx = [&](const AlgEl& e) { return small_call(e, "SXFunction");};
+
+    // Operations that can be expanded together with an SX call
+    auto expandable = [&](const AlgEl& e) {
+      if (small_sx(e) || e.data->is_unary() || e.data->is_binary()) return true;
+      switch (e.op) {
+        case OP_CONST: case OP_TRANSPOSE: case OP_RESHAPE: case OP_PROJECT:
+        case OP_HORZCAT: case OP_VERTCAT: case OP_DIAGCAT:
+        case OP_HORZSPLIT: case OP_VERTSPLIT: case OP_DIAGSPLIT:
+        case OP_GETNONZEROS: case OP_SETNONZEROS: case OP_ADDNONZEROS:
+          return true;
+        default:
+          return false;
+      }
+    };
+
+    // Quick return if nothing to do
+    bool has_mx = std::any_of(algorithm_.begin(), algorithm_.end(), small_mx);
+    bool has_sx = std::any_of(algorithm_.begin(), algorithm_.end(), small_sx);
+    if (!has_mx && !has_sx) return out_;
+    if (verbose_) casadi_message(name_ + "::inline_calls");
+
+    // Symbolic work, non-differentiated
+    vector<MX> swork(workloc_.size()-1);
+
+    // Split up inputs into symbolic primitives
+    vector<vector<MX> > arg_split(in_.size());
+    for (casadi_int i=0; i<in_.size(); ++i) arg_split[i] = in_[i].split_primitives(in_[i]);
+
+    // Allocate storage for split outputs
+    vector<vector<MX> > res_split(out_.size());
+    for (casadi_int i=0; i<out_.size(); ++i) res_split[i].resize(out_[i].n_primitives());
+
+    // Evaluate an instruction symbolically
+    vector<MX> arg1, res1;
+    auto eval_el = [&](const AlgEl& e) {
+      if (e.op == OP_INPUT) {
+        swork[e.res.front()] = arg_split.at(e.data->ind()).at(e.data->segment());
+      } else if (e.op==OP_OUTPUT) {
+        res_split.at(e.data->ind()).at(e.data->segment()) = swork[e.arg.front()];
+      } else if (e.op==OP_PARAMETER) {
+        swork[e.res.front()] = e.data;
+      } else {
+        arg1.resize(e.arg.size());
+        for (casadi_int i=0; i<arg1.size(); ++i) {
+          casadi_int el = e.arg[i];
+          arg1[i] = el<0 ? MX(e.data->dep(i).size()) : swork[el];
+        }
+        res1.resize(e.res.size());
+        if (small_mx(e)) {
+          e.data.which_function().call(arg1, res1, true);
+        } else {
+          e.data->eval_mx(arg1, res1);
+        }
+        for (casadi_int i=0; i<res1.size(); ++i) {
+          casadi_int el = e.res[i];
+          if (el>=0) swork[el] = res1[i];
+        }
+      }
+    };
+
+    if (has_mx) {
+      // Inline small MX callees, then repeat for the calls that were exposed
+      for (auto&& e : algorithm_) eval_el(e);
+      vector<MX> ret(out_.size());
+      for (casadi_int i=0; i<ret.size(); ++i) {
+        ret[i] = project(out_[i].join_primitives(res_split[i]), out_[i].sparsity());
+      }
+      Function tmp(name_, in_, ret, Dict{{"live_variables", false}});
+      return static_cast<const MXFunction*>(tmp.get())->inline_calls(threshold);
+    }
+
+    // Last instruction reading each element of the work vector
+    vector<casadi_int> last_use(swork.size(), -1);
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      for (casadi_int el : algorithm_[k].arg) if (el>=0) last_use[el] = k;
+    }
+
+    // Contiguous segment of expandable instructions
+    vector<casadi_int> seg;
+    bool seg_has_call = false;
+    casadi_int n_expanded = 0;
+    auto flush = [&]() {
+      if (!seg_has_call) {
+        // Nothing to gain, keep the operations
+        for (casadi_int k : seg) eval_el(algorithm_[k]);
+      } else {
+        // Evaluate the segment with symbolic inputs
+        std::map<casadi_int, MX> local;
+        vector<MX> c_in, c_arg, c_out;
+        vector<casadi_int> c_res;
+        for (casadi_int k : seg) {
+          const AlgEl& e = algorithm_[k];
+          arg1.resize(e.arg.size());
+          for (casadi_int i=0; i<arg1.size(); ++i) {
+            casadi_int el = e.arg[i];
+            if (el<0) {
+              arg1[i] = MX(e.data->dep(i).size());
+            } else {
+              auto it = local.find(el);
+              if (it==local.end()) {
+                // Defined before the segment
+                MX v = MX::sym("i" + str(c_in.size()), swork[el].sparsity());
+                c_in.push_back(v);
+                c_arg.push_back(swork[el]);
+                it = local.insert(make_pair(el, v)).first;
+              }
+              arg1[i] = it->second;
+            }
+          }
+          res1.resize(e.res.size());
+          e.data->eval_mx(arg1, res1);
+          for (casadi_int i=0; i<res1.size(); ++i) {
+            casadi_int el = e.res[i];
+            if (el<0) continue;
+            local[el] = res1[i];
+            // Needed after the segment
+            if (last_use[el]>seg.back()) {
+              c_out.push_back(res1[i]);
+              c_res.push_back(el);
+            }
+          }
+        }
+        // Replace the segment with a call to its SX expansion
+        Function c(name_ + "_expand_" + str(n_expanded++), c_in, c_out);
+        c = c.expand();
+        vector<MX> r = c(c_arg);
+        for (casadi_int i=0; i<c_res.size(); ++i) swork[c_res[i]] = r[i];
+      }
+      seg.clear();
+      seg_has_call = false;
+    };
+
+    // Loop over computational nodes in forward order
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (e.op==OP_INPUT || e.op==OP_PARAMETER) {
+        // No dependencies, does not break a segment
+        eval_el(e);
+      } else if (expandable(e)) {
+        seg.push_back(k);
+        if (small_sx(e)) seg_has_call = true;
+      } else {
+        flush();
+        eval_el(e);
+      }
+    }
+    flush();
+
+    // Join split outputs, keeping the original sparsity
+    vector<MX> ret(out_.size());
+    for (casadi_int i=0; i<ret.size(); ++i) {
+      ret[i] = project(out_[i].join_primitives(res_split[i]), out_[i].sparsity());
+    }
+    return ret;
+  }
+
+  std::vector<MX> MXFunction::fold_constants() const {
+    // Can an operation be evaluated once its arguments are known?
+    auto foldable = [](const AlgEl& e) {
+      switch (e.op) {
+        case OP_INPUT: case OP_OUTPUT: case OP_PARAMETER: case OP_MONITOR:
+          return false;
+        case OP_CALL:
+          {
+            Function f = e.data.which_function();
+            return (f.is_a("SXFunction") || f.is_a("MXFunction")) && !f.has_free();
+          }
+        default:
+          return true;
+      }
+    };
+
+    // Evaluate numerically the operations with known arguments, with the same
+    // work vector layout as in eval
+    vector<double> w(sz_w());
+    vector<casadi_int> iw(sz_iw());
+    vector<const double*> arg1(sz_arg());
+    vector<double*> res1(sz_res());
+    vector<bool> known(workloc_.size()-1, false), folded(algorithm_.size(), false);
+    bool any_folded = false;
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (!foldable(e)) continue;
+      bool all_known = true, any_known = false;
+      for (casadi_int el : e.arg) {
+        if (el>=0 && !known[el]) all_known = false;
+        if (el>=0 && known[el]) any_known = true;
+      }
+      if (!all_known) {
+        // Calls with some known arguments are specialized
+        if (any_known && e.op==OP_CALL) any_folded = true;
+        continue;
+      }
+      for (casadi_int i=0; i<e.arg.size(); ++i) {
+        arg1[i] = e.arg[i]>=0 ? get_ptr(w)+workloc_[e.arg[i]] : nullptr;
+      }
+      for (casadi_int i=0; i<e.res.size(); ++i) {
+        res1[i] = e.res[i]>=0 ? get_ptr(w)+workloc_[e.res[i]] : nullptr;
+      }
+      if (e.data->eval(get_ptr(arg1), get_ptr(res1), get_ptr(iw), get_ptr(w))) continue;
+      for (casadi_int el : e.res) if (el>=0) known[el] = true;
+      // Existing constants are kept as they are
+      if (e.op!=OP_CONST) folded[k] = any_folded = true;
+    }
+
+    // Quick return if nothing to do
+    if (!any_folded) return out_;
+    if (verbose_) casadi_message(name_ + "::fold_constants");
+
+    // Symbolic work, non-differentiated
+    vector<MX> swork(workloc_.size()-1);
+
+    // Split up inputs into symbolic primitives
+    vector<vector<MX> > arg_split(in_.size());
+    for (casadi_int i=0; i<in_.size(); ++i) arg_split[i] = in_[i].split_primitives(in_[i]);
+
+    // Allocate storage for split outputs
+    vector<vector<MX> > res_split(out_.size());
+    for (casadi_int i=0; i<out_.size(); ++i) res_split[i].resize(out_[i].n_primitives());
+
+    // Loop over computational nodes in forward order
+    vector<MX> sarg1, sres1;
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (folded[k]) {
+        // Replace by the calculated value
+        for (casadi_int i=0; i<e.res.size(); ++i) {
+          casadi_int el = e.res[i];
+          if (el<0) continue;
+          const double* v = get_ptr(w) + workloc_[el];
+          const Sparsity& sp = e.data->sparsity(i);
+          swork[el] = DM(sp, vector<double>(v, v+sp.nnz()));
+        }
+      } else if (e.op == OP_INPUT) {
+        swork[e.res.front()] = arg_split.at(e.data->ind()).at(e.data->segment());
+      } else if (e.op==OP_OUTPUT) {
+        res_split.at(e.data->ind()).at(e.data->segment()) = swork[e.arg.front()];
+      } else if (e.op==OP_PARAMETER) {
+        swork[e.res.front()] = e.data;
+      } else if (foldable(e) && e.op==OP_CALL) {
+        // Call with some of the arguments known: call a specialized function
+        Function f = e.data.which_function();
+        DMDict values;
+        sarg1.clear();
+        for (casadi_int i=0; i<e.arg.size(); ++i) {
+          casadi_int el = e.arg[i];
+          if (el>=0 && known[el]) {
+            const double* v = get_ptr(w) + workloc_[el];
+            const Sparsity& sp = e.data->dep(i).sparsity();
+            values[f.name_in(i)] = DM(sp, vector<double>(v, v+sp.nnz()));
+          } else {
+            sarg1.push_back(el<0 ? MX(e.data->dep(i).size()) : swork[el]);
+          }
+        }
+        if (!values.empty()) f = f.specialize(f.name(), values);
+        sres1 = f(sarg1);
+        for (casadi_int i=0; i<sres1.size(); ++i) {
+          casadi_int el = e.res[i];
+          if (el>=0) swork[el] = sres1[i];
+        }
+      } else {
+        sarg1.resize(e.arg.size());
+        for (casadi_int i=0; i<sarg1.size(); ++i) {
+          casadi_int el = e.arg[i];
+          sarg1[i] = el<0 ? MX(e.data->dep(i).size()) : swork[el];
+        }
+        sres1.resize(e.res.size());
+        e.data->eval_mx(sarg1, sres1);
+        for (casadi_int i=0; i<sres1.size(); ++i) {
+          casadi_int el = e.res[i];
+          if (el>=0) swork[el] = sres1[i];
+        }
+      }
+    }
+
+    // Join split outputs, keeping the original sparsity
+    vector<MX> ret(out_.size());
+    for (casadi_int i=0; i<ret.size(); ++i) {
+      ret[i] = project(out_[i].join_primitives(res_split[i]), out_[i].sparsity());
+    }
+    return ret;
+  }
+
+  std::vector<MX> MXFunction::reorder_mtimes() const {
+    // Number of uses of each element of the work vector
+    vector<casadi_int> nuse(workloc_.size()-1, 0);
+    for (auto&& e : algorithm_) {
+      for (casadi_int el : e.arg) if (el>=0) nuse[el]++;
+    }
+
+    // Locate the plain matrix products, x*y with a structurally zero z
+    vector<bool> is_prod(algorithm_.size(), false);
+    vector<casadi_int> nfac(workloc_.size()-1, 1);
+    bool any_chain = false;
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (e.op!=OP_MTIMES || e.res[0]<0) continue;
+      // Arguments are z, x and y
+      const MX& z = e.data->dep(0);
+      if (!z.is_zero() || z.sparsity()!=Sparsity::mtimes(e.data->dep(1).sparsity(),
+                                                         e.data->dep(2).sparsity())) continue;
+      is_prod[k] = true;
+      // Number of factors, products used only once are merged into the chain
+      casadi_int n = 0;
+      for (casadi_int i=1; i<3; ++i) {
+        casadi_int el = e.arg[i];
+        n += nuse[el]==1 ? nfac[el] : 1;
+      }
+      nfac[e.res[0]] = n;
+      if (n>2) any_chain = true;
+    }
+
+    // Quick return if nothing to do
+    if (!any_chain) return out_;
+    if (verbose_) casadi_message(name_ + "::reorder_mtimes");
+
+    // Symbolic work, non-differentiated, and the factors of chains not yet multiplied
+    vector<MX> swork(workloc_.size()-1);
+    vector<vector<MX> > factors(workloc_.size()-1);
+    vector<bool> pending(workloc_.size()-1, false);
+    auto get = [&](casadi_int el) -> const MX& {
+      if (pending[el]) {
+        swork[el] = MX::mtimes(factors[el]);
+        factors[el].clear();
+        pending[el] = false;
+      }
+      return swork[el];
+    };
+
+    // Split up inputs into symbolic primitives
+    vector<vector<MX> > arg_split(in_.size());
+    for (casadi_int i=0; i<in_.size(); ++i) arg_split[i] = in_[i].split_primitives(in_[i]);
+
+    // Allocate storage for split outputs
+    vector<vector<MX> > res_split(out_.size());
+    for (casadi_int i=0; i<out_.size(); ++i) res_split[i].resize(out_[i].n_primitives());
+
+    // Loop over computational nodes in forward order
+    vector<MX> sarg1, sres1;
+    for (casadi_int k=0; k<algorithm_.size(); ++k) {
+      const AlgEl& e = algorithm_[k];
+      if (is_prod[k]) {
+        // Extend the chains of the factors
+        vector<MX>& f = factors[e.res[0]];
+        for (casadi_int i=1; i<3; ++i) {
+          casadi_int el = e.arg[i];
+          if (pending[el] && nuse[el]==1) {
+            f.insert(f.end(), factors[el].begin(), factors[el].end());
+            factors[el].clear();
+            pending[el] = false;
+          } else {
+            f.push_back(get(el));
+          }
+        }
+        pending[e.res[0]] = true;
+      } else if (e.op == OP_INPUT) {
+        swork[e.res.front()] = arg_split.at(e.data->ind()).at(e.data->segment());
+      } else if (e.op==OP_OUTPUT) {
+        res_split.at(e.data->ind()).at(e.data->segment()) = get(e.arg.front());
+      } else if (e.op==OP_PARAMETER) {
+        swork[e.res.front()] = e.data;
+      } else {
+        sarg1.resize(e.arg.size());
+        for (casadi_int i=0; i<sarg1.size(); ++i) {
+          casadi_int el = e.arg[i];
+          sarg1[i] = el<0 ? MX(e.data->dep(i).size()) : get(el);
+        }
+        sres1.resize(e.res.size());
+        e.data->eval_mx(sarg1, sres1);
+        for (casadi_int i=0; i<sres1.size(); ++i) {
+          casadi_int el = e.res[i];
+          if (el>=0) swork[el] = sres1[i];
+        }
+      }
+    }
+
+    // Join split outputs, keeping the original sparsity
+    vector<MX> ret(out_.size());
+    for (casadi_int i=0; i<ret.size(); ++i) {
+      ret[i] = project(out_[i].join_primitives(res_split[i]), out_[i].sparsity());
+    }
+    return ret;
+  }
+
   void MXFunction::ad_forward(const std::vector<std::vector<MX> >& fseed,
                                 std::vector<std::vector<MX> >& fsens) const {
     if (verbose_) casadi_message(name_ + "::ad_forward(" + str(fseed.size())+ ")");
@@ -1250,6 +1882,36 @@ namespace casadi {
           MX, MXNode>::is_a(type, recursive));
   }
 
+  Dict MXFunction::memory_footprint() const {
+    Dict fp = FunctionInternal::memory_footprint();
+
+    // Instruction tape, including the work vector offsets
+    size_t alg = algorithm_.capacity()*sizeof(AlgEl) + workloc_.capacity()*sizeof(casadi_int)
+      + (res_dep_.capacity() + in_dep_.capacity())*sizeof(uint64_t);
+    for (auto&& e : algorithm_) {
+      alg += (e.arg.capacity() + e.res.capacity())*sizeof(casadi_int);
+    }
+    add_footprint(fp, "algorithm", alg);
+
+    // Constants stored as nonzeros
+    size_t cst = 0;
+    for (auto&& e : algorithm_) {
+      if (e.op==OP_CONST && dynamic_cast<const ConstantDM*>(e.data.get())) {
+        cst += e.data.nnz()*sizeof(double);
+      }
+    }
+    add_footprint(fp, "constants", cst);
+
+    // Expression graph nodes, excluding called functions
+    Dict nodes;
+    size_t nb = 0;
+    for (auto&& e : algorithm_) nb += sizeof(MXNode) + e.data->n_dep()*sizeof(MX);
+    nodes["count"] = static_cast<casadi_int>(algorithm_.size());
+    add_footprint(nodes, "bytes", nb);
+    add_footprint(fp, "nodes", nodes);
+    return fp;
+  }
+
   void MXFunction::substitute_inplace(std::vector<MX>& vdef, std::vector<MX>& ex) const {
     vector<MX> work(workloc_.size()-1);
     vector<MX> oarg, ores;
@@ -1630,13 +2292,16 @@ namespace casadi {
       if (e.op==OP_CALL) {
         Function d = e.data.which_function();
         if (d.is_a("conic", true)) {
-          if (!dep.is_null()) return {};
+          if (!dep.is_null()) return stats;
           dep = d;
         }
       }
     }
-    if (dep.is_null()) return {};
-    return dep.stats(1);
+    if (dep.is_null()) return stats;
+    // Statistics of the single embedded QP solver
+    Dict dep_stats = dep.stats(1);
+    stats.insert(dep_stats.begin(), dep_stats.end());
+    return stats;
   }
 
 } // namespace casadi
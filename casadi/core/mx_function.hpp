@@ -71,12 +71,23 @@ namespace casadi {
     /** \brief Offsets for elements in the w_ vector */
     std::vector<casadi_int> workloc_;
 
+    /** \brief Demand masks: the outputs depending on each operation result,
+     * in the order of the algorithm, only for functions with multiple outputs */
+    std::vector<uint64_t> res_dep_;
+
+    /** \brief Dependency masks: the inputs each operation depends on,
+     * only for incremental evaluation */
+    std::vector<uint64_t> in_dep_;
+
     /// Free variables
     std::vector<MX> free_vars_;
 
     /// Default input values
     std::vector<double> default_in_;
 
+    /// Reassociate chains of matrix products, also in derivative functions
+    bool reorder_mtimes_;
+
     /** \brief Constructor */
     MXFunction(const std::string& name,
       const std::vector<MX>& input, const std::vector<MX>& output,
@@ -98,6 +109,9 @@ namespace casadi {
     /** \brief Check if the function is of a particular type */
     bool is_a(const std::string& type, bool recursive) const override;
 
+    /** \brief Estimate the memory used, in bytes */
+    Dict memory_footprint() const override;
+
     ///@{
     /** \brief Options */
     static Options options_;
@@ -137,6 +151,31 @@ namespace casadi {
     void eval_mx(const MXVector& arg, MXVector& res,
                  bool always_inline, bool never_inline) const override;
 
+    /** \brief Outputs with calls to functions of at most \a threshold instructions inlined
+     *
+     * MX callees are inlined into the graph. Contiguous runs of SX calls and cheap
+     * operations are replaced by a single call to their SX expansion.
+     * Larger callees remain calls. Requires a graph without live variables.
+     */
+    std::vector<MX> inline_calls(casadi_int threshold) const;
+
+    /** \brief Outputs with the subexpressions that only depend on constants evaluated
+     *
+     * Operations whose arguments are all constant are evaluated numerically and
+     * replaced by constants. Calls are only evaluated for SX and MX functions,
+     * which are specialized when some of the arguments are constant.
+     * Requires a graph without live variables.
+     */
+    std::vector<MX> fold_constants() const;
+
+    /** \brief Outputs with chains of matrix products reassociated
+     *
+     * Nested products whose intermediate results are not used elsewhere are
+     * collected into chains, which are multiplied in the order with the lowest
+     * estimated cost, see MX::mtimes. Requires a graph without live variables.
+     */
+    std::vector<MX> reorder_mtimes() const;
+
     /** \brief Calculate forward mode directional derivatives */
     void ad_forward(const std::vector<std::vector<MX> >& fwdSeed,
                         std::vector<std::vector<MX> >& fwdSens) const;
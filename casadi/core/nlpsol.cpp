@@ -57,6 +57,7 @@ namespace casadi {
   Function Nlpsol::create_oracle(const std::map<std::string, XType>& d,
                                  const Dict& opts) {
     std::vector<XType> nl_in(NL_NUM_IN), nl_out(NL_NUM_OUT);
+    std::vector<std::string> nl_out_names = NL_OUTPUTS;
     for (auto&& i : d) {
       if (i.first=="x") {
         nl_in[NL_X]=i.second;
@@ -66,6 +67,10 @@ namespace casadi {
         nl_out[NL_F]=i.second;
       } else if (i.first=="g") {
         nl_out[NL_G]=i.second;
+      } else if (i.first=="r") {
+        // Least-squares residual, optional, used for Gauss-Newton Hessians
+        nl_out.push_back(i.second);
+        nl_out_names.push_back("r");
       } else {
         casadi_error("No such field: " + i.first);
       }
@@ -85,7 +90,7 @@ namespace casadi {
     }
 
     // Create oracle
-    return Function("nlp", nl_in, nl_out, NL_INPUTS, NL_OUTPUTS, oracle_options);
+    return Function("nlp", nl_in, nl_out, NL_INPUTS, nl_out_names, oracle_options);
   }
 
   Function nlpsol(const std::string& name, const std::string& solver,
@@ -508,30 +513,8 @@ namespace casadi {
 
   void Nlpsol::bound_consistency(casadi_int n, double* x, double* lam,
                                  const double* lbx, const double* ubx) {
-    // NOTE: Move to C runtime?
     casadi_assert(x!=nullptr && lam!=nullptr, "Need x, lam");
-    // Local variables
-    casadi_int i;
-    double lb, ub;
-    // Loop over variables
-    for (i=0; i<n; ++i) {
-      // Get bounds
-      lb = lbx ? lbx[i] : 0.;
-      ub = ubx ? ubx[i] : 0.;
-      // Make sure bounds are respected
-      x[i] = std::fmin(std::fmax(x[i], lb), ub);
-      // Adjust multipliers
-      if (std::isinf(lb) && std::isinf(ub)) {
-        // Both multipliers are infinite
-        lam[i] = 0.;
-      } else if (std::isinf(lb) || x[i] - lb > ub - x[i]) {
-        // Infinite lower bound or closer to upper bound than lower bound
-        lam[i] = std::fmax(0., lam[i]);
-      } else if (std::isinf(ub) || x[i] - lb < ub - x[i]) {
-        // Infinite upper bound or closer to lower bound than upper bound
-        lam[i] = std::fmin(0., lam[i]);
-      }
-    }
+    casadi_bound_consistency(n, x, lam, lbx, ubx);
   }
 
   int Nlpsol::eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
@@ -626,6 +609,88 @@ namespace casadi {
     return flag;
   }
 
+  void Nlpsol::codegen_declarations(CodeGenerator& g) const {
+    if (calc_f_ || calc_g_ || calc_lam_x_ || calc_lam_p_) {
+      g.add_dependency(get_function("nlp_grad"));
+    }
+  }
+
+  void Nlpsol::codegen_body_enter(CodeGenerator& g) const {
+    casadi_assert(fcallback_.is_null(),
+      "Code generation not supported for 'iteration_callback'");
+    g.local("d_p", "const casadi_real", "*");
+    g.local("d_lbx", "const casadi_real", "*");
+    g.local("d_ubx", "const casadi_real", "*");
+    g.local("d_lbg", "const casadi_real", "*");
+    g.local("d_ubg", "const casadi_real", "*");
+    g.local("d_x", "casadi_real", "*");
+    g.local("d_lam_x", "casadi_real", "*");
+    g.local("d_lam_g", "casadi_real", "*");
+    g.local("d_lam_p", "casadi_real", "*");
+    g.local("d_g", "casadi_real", "*");
+    g.local("d_f", "casadi_real");
+
+    // Bounds, given parameter values
+    g << "d_p = arg[" << NLPSOL_P << "];\n";
+    g << "d_lbx = arg[" << NLPSOL_LBX << "];\n";
+    g << "d_ubx = arg[" << NLPSOL_UBX << "];\n";
+    g << "d_lbg = arg[" << NLPSOL_LBG << "];\n";
+    g << "d_ubg = arg[" << NLPSOL_UBG << "];\n";
+
+    // Work vectors, same order as in set_work
+    g << "d_x = w; w += " << nx_ << ";\n";
+    g << "d_lam_x = w; w += " << nx_ << ";\n";
+    g << "d_lam_g = w; w += " << ng_ << ";\n";
+    g << "d_lam_p = w; w += " << np_ << ";\n";
+    g << "d_g = w; w += " << ng_ << ";\n";
+
+    // Set initial guess
+    g.comment("Initial guess");
+    g << g.copy("arg[" + str(NLPSOL_X0) + "]", nx_, "d_x") << "\n";
+    g << g.copy("arg[" + str(NLPSOL_LAM_X0) + "]", nx_, "d_lam_x") << "\n";
+    g << g.copy("arg[" + str(NLPSOL_LAM_G0) + "]", ng_, "d_lam_g") << "\n";
+    g << g.fill("d_lam_p", np_, g.constant(nan)) << "\n";
+    g << "d_f = " << g.constant(nan) << ";\n";
+    g << g.fill("d_g", ng_, g.constant(nan)) << "\n";
+  }
+
+  void Nlpsol::codegen_body_exit(CodeGenerator& g) const {
+    // Calculate multipliers
+    if (calc_f_ || calc_g_ || calc_lam_x_ || calc_lam_p_) {
+      g.comment("Calculate multipliers");
+      g.local("lam_f", "casadi_real");
+      g << "lam_f = 1.;\n";
+      g << "arg[" << n_in_ << "] = d_x;\n";
+      g << "arg[" << n_in_+1 << "] = d_p;\n";
+      g << "arg[" << n_in_+2 << "] = &lam_f;\n";
+      g << "arg[" << n_in_+3 << "] = d_lam_g;\n";
+      g << "res[" << n_out_ << "] = " << (calc_f_ ? "&d_f" : "0") << ";\n";
+      g << "res[" << n_out_+1 << "] = " << (calc_g_ ? "d_g" : "0") << ";\n";
+      g << "res[" << n_out_+2 << "] = " << (calc_lam_x_ ? "d_lam_x" : "0") << ";\n";
+      g << "res[" << n_out_+3 << "] = " << (calc_lam_p_ ? "d_lam_p" : "0") << ";\n";
+      g << "if (" << g(get_function("nlp_grad"), "arg+" + str(n_in_), "res+" + str(n_out_),
+                       "iw", "w", "0") << ") return 1;\n";
+      if (calc_lam_x_) g << g.scal(nx_, "-1.", "d_lam_x") << "\n";
+      if (calc_lam_p_) g << g.scal(np_, "-1.", "d_lam_p") << "\n";
+    }
+
+    // Make sure that an optimal solution is consistant with bounds
+    if (bound_consistency_) {
+      g.add_auxiliary(CodeGenerator::AUX_BOUNDS_CONSISTENCY);
+      g << "casadi_bound_consistency(" << nx_ << ", d_x, d_lam_x, d_lbx, d_ubx);\n";
+      g << "casadi_bound_consistency(" << ng_ << ", d_g, d_lam_g, d_lbg, d_ubg);\n";
+    }
+
+    // Get optimal solution
+    g.comment("Get optimal solution");
+    g << g.copy("d_x", nx_, "res[" + str(NLPSOL_X) + "]") << "\n";
+    g << g.copy("d_lam_x", nx_, "res[" + str(NLPSOL_LAM_X) + "]") << "\n";
+    g << g.copy("d_lam_g", ng_, "res[" + str(NLPSOL_LAM_G) + "]") << "\n";
+    g << g.copy("d_lam_p", np_, "res[" + str(NLPSOL_LAM_P) + "]") << "\n";
+    g << g.copy("&d_f", 1, "res[" + str(NLPSOL_F) + "]") << "\n";
+    g << g.copy("d_g", ng_, "res[" + str(NLPSOL_G) + "]") << "\n";
+  }
+
   void Nlpsol::set_work(void* mem, const double**& arg, double**& res,
                         casadi_int*& iw, double*& w) const {
     auto m = static_cast<NlpsolMemory*>(mem);
@@ -659,13 +724,16 @@ namespace casadi {
   }
 
   Function Nlpsol::kkt() const {
+    // Concurrent calls wait for a single generation
+    GenerationLock lock;
+    lock.lock();
+
     // Quick return if cached
-    if (kkt_.alive()) {
-      return shared_cast<Function>(kkt_.shared());
-    }
+    Function ret = shared_cast<Function>(kkt_.shared());
+    if (!ret.is_null()) return ret;
 
     // Generate KKT function
-    Function ret = oracle_.factory("kkt", {"x", "p", "lam:f", "lam:g"},
+    ret = oracle_.factory("kkt", {"x", "p", "lam:f", "lam:g"},
       {"jac:g:x", "sym:hess:gamma:x:x"}, {{"gamma", {"f", "g"}}});
 
     // Cache and return
@@ -164,6 +164,15 @@ namespace casadi {
     // Solve the NLP
     virtual int solve(void* mem) const = 0;
 
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for setting up the work vectors and initial guess */
+    void codegen_body_enter(CodeGenerator& g) const;
+
+    /** \brief Generate code for post-processing and passing the solution */
+    void codegen_body_exit(CodeGenerator& g) const;
+
     /** \brief Do the derivative functions need nondifferentiated outputs? */
     bool uses_output() const override {return true;}
 
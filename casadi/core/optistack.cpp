@@ -185,6 +185,14 @@ DM Opti::value(const SX& x, const std::vector<MX>& values) const {
   }
 }
 
+std::vector<DM> Opti::values(const std::vector<MX>& x, const std::vector<MX>& values) const {
+  try {
+    return (*this)->values(x, values);
+  } catch (exception& e) {
+    THROW_ERROR("values", e.what());
+  }
+}
+
 Dict Opti::stats() const {
   try {
     return (*this)->stats();
@@ -721,6 +729,11 @@ DM OptiSol::value(const SX& x, const std::vector<MX>& values) const {
   return optistack_.value(x, values);
 }
 
+std::vector<DM> OptiSol::values(const std::vector<MX>& x,
+    const std::vector<MX>& values) const {
+  return optistack_.values(x, values);
+}
+
 std::vector<MX> OptiSol::value_variables() const {
   return optistack_.value_variables();
 }
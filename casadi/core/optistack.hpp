@@ -208,6 +208,19 @@ public:
   native_DM value(const SX& x, const std::vector<MX>& values=std::vector<MX>()) const;
   /// @}
 
+  /** \brief Obtain values of a list of expressions at the current value
+  *
+  * Equivalent to calling value on each expression, but evaluates
+  * all expressions in one go.
+  * Evaluation helpers are cached, so repeated calls with the same
+  * expressions only perform numerical work.
+  *
+  * \param[in] values Optional assignment expressions (e.g. x==3)
+  *            to overrule the current value
+  */
+  std::vector<DM> values(const std::vector<MX>& x,
+    const std::vector<MX>& values=std::vector<MX>()) const;
+
   /** \brief Get statistics
   *
   * nlpsol stats are passed as-is.
@@ -535,6 +548,17 @@ class CASADI_EXPORT OptiSol : public SWIG_IF_ELSE(PrintableCommon, Printable<Opt
     native_DM value(const SX& x, const std::vector<MX>& values=std::vector<MX>()) const;
     /// @}
 
+    /** \brief Obtain values of a list of expressions at the current value
+    *
+    * Equivalent to calling value on each expression, but evaluates
+    * all expressions in one go.
+    *
+    * \param[in] values Optional assignment expressions (e.g. x==3)
+    *            to overrule the current value
+    */
+    std::vector<DM> values(const std::vector<MX>& x,
+      const std::vector<MX>& values=std::vector<MX>()) const;
+
     /// get assignment expressions for the optimal solution
     std::vector<MX> value_variables() const;
     std::vector<MX> value_parameters() const;
@@ -1000,16 +1000,49 @@ bool override_num(const std::map<casadi_int, MX> & temp, std::vector<DM>& num, c
   return false;
 }
 
-DM OptiNode::value(const MX& expr, const std::vector<MX>& values) const {
-  std::vector<MX> x   = symvar(expr, OPTI_VAR);
-  std::vector<MX> p   = symvar(expr, OPTI_PAR);
-  std::vector<MX> lam = symvar(expr, OPTI_DUAL_G);
+bool OptiNode::ExprLess::operator()(const std::vector<MX>& a,
+                                    const std::vector<MX>& b) const {
+  if (a.size()!=b.size()) return a.size()<b.size();
+  for (casadi_int k=0; k<a.size(); ++k) {
+    if (a[k].get()!=b[k].get()) return a[k].get()<b[k].get();
+  }
+  return false;
+}
+
+const OptiNode::ValueHelper& OptiNode::value_helper(const std::vector<MX>& expr) const {
+  // Cache hit: no symbolic work needed
+  auto it = value_helpers_.find(expr);
+  if (it!=value_helpers_.end()) return it->second;
+
+  // Bound the memory held by the cache, e.g. with fresh expressions in a loop
+  if (value_helpers_.size()>=max_value_helpers) value_helpers_.clear();
+
+  ValueHelper h;
+  MX total_expr = veccat(expr);
+  h.x   = symvar(total_expr, OPTI_VAR);
+  h.p   = symvar(total_expr, OPTI_PAR);
+  h.lam = symvar(total_expr, OPTI_DUAL_G);
 
-  Function helper = Function("helper", std::vector<MX>{veccat(x), veccat(p), veccat(lam)}, {expr});
-  if (helper.has_free())
+  h.f = Function("helper", std::vector<MX>{veccat(h.x), veccat(h.p), veccat(h.lam)}, expr);
+  if (h.f.has_free())
     casadi_error("This expression has symbols that are not defined "
       "within Opti using variable/parameter.");
 
+  return value_helpers_.insert(std::make_pair(expr, h)).first->second;
+}
+
+DM OptiNode::value(const MX& expr, const std::vector<MX>& values) const {
+  return this->values(std::vector<MX>{expr}, values)[0];
+}
+
+std::vector<DM> OptiNode::values(const std::vector<MX>& expr,
+    const std::vector<MX>& values) const {
+  if (expr.empty()) return {};
+  const ValueHelper& h = value_helper(expr);
+  const std::vector<MX>& x = h.x;
+  const std::vector<MX>& p = h.p;
+  const std::vector<MX>& lam = h.lam;
+
   std::map<VariableType, std::map<casadi_int, MX> > temp;
   temp[OPTI_DUAL_G] = std::map<casadi_int, MX>();
   for (const auto& v : values) {
@@ -1059,8 +1092,7 @@ DM OptiNode::value(const MX& expr, const std::vector<MX>& values) const {
         describe(e, 1));
   }
 
-  std::vector<DM> arg = helper(std::vector<DM>{veccat(x_num), veccat(p_num), veccat(lam_num)});
-  return arg[0];
+  return h.f(std::vector<DM>{veccat(x_num), veccat(p_num), veccat(lam_num)});
 }
 
 void OptiNode::assert_active_symbol(const MX& m) const {
@@ -108,6 +108,13 @@ public:
   }
   /// @}
 
+  /** \brief Obtain values of many expressions at the current value
+  *
+  * All expressions are evaluated with one combined helper Function
+  */
+  std::vector<DM> values(const std::vector<MX>& x,
+    const std::vector<MX>& values=std::vector<MX>()) const;
+
   /// Copy
   Opti copy() const;
 
@@ -264,7 +271,11 @@ public:
   static OptiNode* create();
 
   bool problem_dirty_;
-  void mark_problem_dirty(bool flag=true) { problem_dirty_=flag; mark_solver_dirty(); }
+  void mark_problem_dirty(bool flag=true) {
+    problem_dirty_=flag;
+    if (flag) value_helpers_.clear();
+    mark_solver_dirty();
+  }
   bool problem_dirty() const { return problem_dirty_; }
 
   bool solver_dirty_;
@@ -353,6 +364,30 @@ private:
   MXDict nlp_;
   MX lam_;
 
+  /// Evaluation helper for value: [x, p, lam] -> exprs
+  struct ValueHelper {
+    /// Opti symbols the expressions depend on
+    std::vector<MX> x, p, lam;
+    /// Helper function
+    Function f;
+  };
+
+  /// Get (or create and cache) an evaluation helper for expressions
+  const ValueHelper& value_helper(const std::vector<MX>& expr) const;
+
+  /// Order expressions by node identity
+  struct ExprLess {
+    bool operator()(const std::vector<MX>& a, const std::vector<MX>& b) const;
+  };
+
+  /** \brief Cache of evaluation helpers, keyed by the expressions
+   *
+   * The keys keep the expressions alive. The cache is cleared when the problem
+   * changes and when it reaches max_value_helpers entries.
+   */
+  mutable std::map<std::vector<MX>, ValueHelper, ExprLess> value_helpers_;
+  static const casadi_int max_value_helpers = 64;
+
   /// Bounds helper function: p -> lbg, ubg
   Function bounds_;
   MX bounds_lbg_;
@@ -314,10 +314,10 @@ namespace casadi {
   }
 
   Dict OracleFunction::get_stats(void *mem) const {
+    Dict stats = FunctionInternal::get_stats(mem);
     auto m = static_cast<OracleMemory*>(mem);
 
     // Add timing statistics
-    Dict stats;
     for (auto&& s : m->fstats) {
       stats["n_call_" +s.first] = s.second.n_call;
       stats["t_wall_" +s.first] = s.second.t_wall;
@@ -355,6 +355,12 @@ namespace casadi {
     return ret;
   }
 
+  Dict OracleFunction::memory_footprint() const {
+    Dict fp = FunctionInternal::memory_footprint();
+    add_footprint(fp, "oracle", oracle_->memory_footprint());
+    return fp;
+  }
+
   const Function& OracleFunction::get_function(const std::string &name) const {
     auto it = all_functions_.find(name);
     casadi_assert(it!=all_functions_.end(),
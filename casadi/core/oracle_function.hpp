@@ -126,6 +126,9 @@ namespace casadi {
     // Check if a particular dependency exists
     bool has_function(const std::string& fname) const override;
 
+    /** \brief Estimate the memory used, in bytes */
+    Dict memory_footprint() const override;
+
     /** \brief Export / Generate C code for the generated functions */
     std::string generate_dependencies(const std::string& fname, const Dict& opts) const override;
 
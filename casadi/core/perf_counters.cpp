@@ -0,0 +1,107 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "perf_counters.hpp"
+#include "exception.hpp"
+
+using namespace std;
+namespace casadi {
+
+  std::atomic<bool> PerfCounters::enabled_(false);
+  std::atomic<long long> PerfCounters::count_[PerfCounters::N_EVENT];
+  std::atomic<long long> PerfCounters::time_[PerfCounters::N_EVENT];
+
+  const char* PerfCounters::name(Event e) {
+    switch (e) {
+      case FUNCTION_CONSTRUCT: return "function_construct";
+      case CACHE_HIT: return "cache_hit";
+      case CACHE_MISS: return "cache_miss";
+      case SPARSITY_CACHE_HIT: return "sparsity_cache_hit";
+      case SPARSITY_CACHE_MISS: return "sparsity_cache_miss";
+      case CHECKOUT: return "checkout";
+      case CHECKOUT_ALLOC: return "checkout_alloc";
+      case PLUGIN_LOAD: return "plugin_load";
+      case JIT_COMPILE: return "jit_compile";
+      case LINSOL_NFACT: return "linsol_nfact";
+      default: break;
+    }
+    return nullptr;
+  }
+
+  // Events with a duration
+  static bool is_timed(PerfCounters::Event e) {
+    switch (e) {
+      case PerfCounters::FUNCTION_CONSTRUCT:
+      case PerfCounters::PLUGIN_LOAD:
+      case PerfCounters::JIT_COMPILE:
+      case PerfCounters::LINSOL_NFACT:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  PerfCounters::Event PerfCounters::event(const std::string& name) {
+    for (casadi_int e=0; e<N_EVENT; ++e) {
+      if (name==PerfCounters::name(static_cast<Event>(e))) return static_cast<Event>(e);
+    }
+    casadi_error("No such event: '" + name + "'. Available events: " + str(events()));
+  }
+
+  void PerfCounters::reset() {
+    for (casadi_int e=0; e<N_EVENT; ++e) {
+      count_[e] = 0;
+      time_[e] = 0;
+    }
+  }
+
+  casadi_int PerfCounters::count(const std::string& event) {
+    return count_[PerfCounters::event(event)];
+  }
+
+  double PerfCounters::time(const std::string& event) {
+    return static_cast<double>(time_[PerfCounters::event(event)])*1e-9;
+  }
+
+  std::vector<std::string> PerfCounters::events() {
+    std::vector<std::string> ret;
+    for (casadi_int e=0; e<N_EVENT; ++e) ret.push_back(name(static_cast<Event>(e)));
+    return ret;
+  }
+
+  Dict PerfCounters::stats() {
+    Dict ret;
+    for (casadi_int e=0; e<N_EVENT; ++e) {
+      Dict s;
+      s["count"] = static_cast<casadi_int>(count_[e]);
+      if (is_timed(static_cast<Event>(e))) {
+        s["time"] = static_cast<double>(time_[e])*1e-9;
+      }
+      ret[name(static_cast<Event>(e))] = s;
+    }
+    return ret;
+  }
+
+} // namespace casadi
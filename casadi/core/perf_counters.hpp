@@ -0,0 +1,151 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_PERF_COUNTERS_HPP
+#define CASADI_PERF_COUNTERS_HPP
+
+#include "generic_type.hpp"
+
+#ifndef SWIG
+#include <atomic>
+#include <chrono>
+#endif // SWIG
+
+namespace casadi {
+
+  /**
+  * \brief Global counters of internal events
+  *
+  * Counts, and for some events times, internal events such as Function
+  * constructions, derivative cache lookups and linear solver factorizations.
+  * Disabled by default, in which case the cost is a single check per event.
+  * The counters are thread-safe.
+  *
+  * Times are inclusive, e.g. the construction time of a Function includes
+  * the construction of the Functions created during its initialization.
+  *
+  * This class must never be instantiated. Access its static members directly.
+  */
+  class CASADI_EXPORT PerfCounters {
+    private:
+      /// No instances are allowed
+      PerfCounters();
+    public:
+
+#ifndef SWIG
+      /// Events
+      enum Event {
+        FUNCTION_CONSTRUCT,
+        CACHE_HIT,
+        CACHE_MISS,
+        SPARSITY_CACHE_HIT,
+        SPARSITY_CACHE_MISS,
+        CHECKOUT,
+        CHECKOUT_ALLOC,
+        PLUGIN_LOAD,
+        JIT_COMPILE,
+        LINSOL_NFACT,
+        N_EVENT
+      };
+
+      /// Is counting enabled?
+      static std::atomic<bool> enabled_;
+
+      /// Number of occurrences of each event
+      static std::atomic<long long> count_[N_EVENT];
+
+      /// Accumulated time of each event, in nanoseconds
+      static std::atomic<long long> time_[N_EVENT];
+
+      /// Count an event
+      static void count(Event e) {
+        if (enabled_.load(std::memory_order_relaxed)) {
+          count_[e].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+
+      /// Count an event, with its duration in nanoseconds
+      static void add(Event e, long long ns) {
+        count_[e].fetch_add(1, std::memory_order_relaxed);
+        time_[e].fetch_add(ns, std::memory_order_relaxed);
+      }
+
+      /// Name of an event
+      static const char* name(Event e);
+
+      /// Times the enclosing scope, if enabled at its start
+      class Timer {
+      public:
+        explicit Timer(Event e) : e_(e), active_(enabled_.load(std::memory_order_relaxed)) {
+          if (active_) start_ = std::chrono::steady_clock::now();
+        }
+        ~Timer() {
+          if (active_) {
+            add(e_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start_).count());
+          }
+        }
+      private:
+        Event e_;
+        bool active_;
+        std::chrono::steady_clock::time_point start_;
+      };
+#endif // SWIG
+
+      /// Enable or disable counting
+      static void enable(bool flag=true) { enabled_ = flag;}
+
+      /// Is counting enabled?
+      static bool is_enabled() { return enabled_;}
+
+      /// Set all counters to zero
+      static void reset();
+
+      /// Number of occurrences of an event
+      static casadi_int count(const std::string& event);
+
+      /// Accumulated time of an event, in seconds
+      static double time(const std::string& event);
+
+      /// Names of all events
+      static std::vector<std::string> events();
+
+      /** \brief Counters of all events
+       *
+       * Returns a dictionary with, for each event, a dictionary with
+       * entries "count" and, for timed events, "time" (in seconds).
+       */
+      static Dict stats();
+
+#ifndef SWIG
+    private:
+      /// Event given by name
+      static Event event(const std::string& name);
+#endif // SWIG
+  };
+
+} // namespace casadi
+
+#endif // CASADI_PERF_COUNTERS_HPP
@@ -25,6 +25,7 @@
 
 #include "function_internal.hpp"
 #include "global_options.hpp"
+#include "perf_counters.hpp"
 
 #include <stdlib.h>
 
@@ -133,6 +134,9 @@ namespace casadi {
 
   template<class Derived>
   bool PluginInterface<Derived>::has_plugin(const std::string& pname, bool verbose) {
+    // The plugin registry is shared between threads
+    FunctionInternal::GenerationLock lock;
+    lock.lock();
 
     // Quick return if available
     if (Derived::solvers_.find(pname) != Derived::solvers_.end()) {
@@ -309,6 +313,9 @@ namespace casadi {
 #ifndef WITH_DL
     casadi_error("WITH_DL option needed for dynamic loading");
 #else // WITH_DL
+    // Time loading and registration
+    PerfCounters::Timer timer(PerfCounters::PLUGIN_LOAD);
+
     // Retrieve the registration function
     RegFcn reg;
 
@@ -363,6 +370,9 @@ namespace casadi {
   template<class Derived>
   typename PluginInterface<Derived>::Plugin&
   PluginInterface<Derived>::getPlugin(const std::string& pname) {
+    // The plugin registry is shared between threads
+    FunctionInternal::GenerationLock lock;
+    lock.lock();
 
     // Check if the solver has been loaded
     auto it=Derived::solvers_.find(pname);
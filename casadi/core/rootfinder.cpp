@@ -26,7 +26,7 @@
 #include "rootfinder_impl.hpp"
 #include "mx_node.hpp"
 #include <iterator>
-#include "linsol.hpp"
+#include "linsol_internal.hpp"
 
 #include "global_options.hpp"
 
@@ -534,6 +534,12 @@ namespace casadi {
     }
   }
 
+  Dict Rootfinder::memory_footprint() const {
+    Dict fp = OracleFunction::memory_footprint();
+    if (!linsol_.is_null()) add_footprint(fp, "linsol", linsol_->memory_footprint());
+    return fp;
+  }
+
   Dict Rootfinder::get_stats(void* mem) const {
     Dict stats = OracleFunction::get_stats(mem);
     auto m = static_cast<RootfinderMemory*>(mem);
@@ -101,6 +101,9 @@ namespace casadi {
     /// Get all statistics
     Dict get_stats(void* mem) const override;
 
+    /** \brief Estimate the memory used, in bytes */
+    Dict memory_footprint() const override;
+
     /** \brief  Propagate sparsity forward */
     int sp_forward(const bvec_t** arg, bvec_t** res,
                     casadi_int* iw, bvec_t* w, void* mem) const override;
@@ -0,0 +1,33 @@
+// NOLINT(legal/copyright)
+
+// C-REPLACE "fmin" "casadi_fmin"
+// C-REPLACE "fmax" "casadi_fmax"
+
+// SYMBOL "bound_consistency"
+// Make sure that a primal-dual solution is consistent with the bounds
+template<typename T1>
+void casadi_bound_consistency(casadi_int n, T1* x, T1* lam,
+                              const T1* lbx, const T1* ubx) {
+  // Local variables
+  casadi_int i;
+  T1 lb, ub;
+  // Loop over variables
+  for (i=0; i<n; ++i) {
+    // Get bounds
+    lb = lbx ? lbx[i] : 0.;
+    ub = ubx ? ubx[i] : 0.;
+    // Make sure bounds are respected
+    x[i] = fmin(fmax(x[i], lb), ub);
+    // Adjust multipliers
+    if (isinf(lb) && isinf(ub)) {
+      // Both multipliers are infinite
+      lam[i] = 0.;
+    } else if (isinf(lb) || x[i] - lb > ub - x[i]) {
+      // Infinite lower bound or closer to upper bound than lower bound
+      lam[i] = fmax(0., lam[i]);
+    } else if (isinf(ub) || x[i] - lb < ub - x[i]) {
+      // Infinite upper bound or closer to lower bound than upper bound
+      lam[i] = fmin(0., lam[i]);
+    }
+  }
+}
@@ -1,4 +1,6 @@
 // NOLINT(legal/copyright)
+
+// C-REPLACE "fmax" "casadi_fmax"
 // SYMBOL "max_viol"
 template<typename T1>
 T1 casadi_max_viol(casadi_int n, const T1* x, const T1* lb, const T1* ub) {
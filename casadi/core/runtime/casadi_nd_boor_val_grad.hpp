@@ -0,0 +1,120 @@
+// NOLINT(legal/copyright)
+// SYMBOL "nd_boor_val_grad"
+template<typename T1>
+void casadi_nd_boor_val_grad(T1* ret, T1* grad, casadi_int n_dims, const T1* all_knots, const casadi_int* offset, const casadi_int* all_degree, const casadi_int* strides, const T1* c, casadi_int m, const T1* all_x, const casadi_int* lookup_mode, casadi_int* iw, T1* w) { // NOLINT(whitespace/line_length)
+  casadi_int n_iter, k, i, j, l, max_degree;
+  casadi_int *boor_offset, *starts, *index;
+  T1 *all_boor, *all_dboor;
+
+  // Quick return
+  if (!ret && !grad) return;
+
+  boor_offset = iw; iw+=n_dims+1;
+  starts = iw; iw+=n_dims;
+  index = iw; iw+=n_dims;
+
+  // Basis functions and their derivatives, stacked over all dimensions
+  boor_offset[0] = 0;
+  max_degree = 0;
+  n_iter = 1;
+  for (k=0;k<n_dims;++k) {
+    boor_offset[k+1] = boor_offset[k] + all_degree[k]+1;
+    if (all_degree[k]>max_degree) max_degree = all_degree[k];
+    n_iter*= all_degree[k]+1;
+  }
+  all_boor = w; w += boor_offset[n_dims]+max_degree;
+  all_dboor = w;
+
+  for (k=0;k<n_dims;++k) {
+    T1 *boor, *dboor;
+    const T1* knots;
+    T1 x;
+    casadi_int degree, n_knots, n_b, L, start;
+    boor = all_boor+boor_offset[k];
+    dboor = all_dboor+boor_offset[k];
+
+    degree = all_degree[k];
+    knots = all_knots + offset[k];
+    n_knots = offset[k+1]-offset[k];
+    n_b = n_knots-degree-1;
+
+    x = all_x[k];
+    L = casadi_low(x, knots+degree, n_knots-2*degree, lookup_mode[k]);
+
+    start = L;
+    if (start>n_b-degree-1) start = n_b-degree-1;
+
+    starts[k] = start;
+
+    casadi_fill(boor, 2*degree+1, 0.0);
+    if (x>=knots[0] && x<=knots[n_knots-1]) {
+      if (x==knots[1]) {
+        casadi_fill(boor, degree+1, 1.0);
+      } else if (x==knots[n_knots-1]) {
+        boor[degree] = 1;
+      } else if (knots[L+degree]==x) {
+        boor[degree-1] = 1;
+      } else {
+        boor[degree] = 1;
+      }
+    }
+    if (degree==0) {
+      dboor[0] = 0;
+    } else {
+      // Basis functions of one degree lower
+      casadi_de_boor(x, knots+start, 2*degree+2, degree-1, boor);
+      // Last recursion step, differentiated alongside
+      knots += start;
+      for (i=0;i<degree+1;++i) {
+        T1 b, db, bottom;
+        b = 0;
+        db = 0;
+        bottom = knots[i + degree] - knots[i];
+        if (bottom) {
+          b = (x - knots[i]) * boor[i] / bottom;
+          db = degree * boor[i] / bottom;
+        }
+        bottom = knots[i + degree + 1] - knots[i + 1];
+        if (bottom) {
+          b += (knots[i + degree + 1] - x) * boor[i + 1] / bottom;
+          db -= degree * boor[i + 1] / bottom;
+        }
+        boor[i] = b;
+        dboor[i] = db;
+      }
+    }
+  }
+
+  // Loop over all coefficients with nonzero basis functions
+  if (ret) casadi_fill(ret, m, 0.0);
+  if (grad) casadi_fill(grad, n_dims*m, 0.0);
+  casadi_fill_casadi_int(index, n_dims, 0);
+  for (l=0;l<n_iter;++l) {
+    casadi_int coeff_offset;
+    T1 v;
+    // Offset in coefficients and product of basis functions
+    coeff_offset = 0;
+    v = 1;
+    for (k=0;k<n_dims;++k) {
+      coeff_offset += (starts[k]+index[k])*strides[k];
+      v *= all_boor[boor_offset[k]+index[k]];
+    }
+    if (ret) {
+      for (i=0;i<m;++i) ret[i] += c[coeff_offset+i]*v;
+    }
+    if (grad) {
+      for (k=0;k<n_dims;++k) {
+        v = 1;
+        for (j=0;j<n_dims;++j) {
+          v *= j==k ? all_dboor[boor_offset[j]+index[j]] : all_boor[boor_offset[j]+index[j]];
+        }
+        for (i=0;i<m;++i) grad[k*m+i] += c[coeff_offset+i]*v;
+      }
+    }
+    // Increment index
+    for (k=0;k<n_dims;++k) {
+      if (++index[k]<=all_degree[k]) break;
+      index[k] = 0;
+    }
+  }
+}
@@ -158,6 +158,13 @@ namespace casadi {
   T1 casadi_interpn(casadi_int ndim, const T1* grid, const casadi_int* offset, const T1* values,
                             const T1* x, casadi_int* iw, T1* w);
 
+  // Multilinear interpolant - calculate value and gradient in one pass
+  template<typename T1>
+  void casadi_interpn_val_grad(T1* res, T1* grad, casadi_int ndim, const T1* grid,
+                               const casadi_int* offset, const T1* values, const T1* x,
+                               const casadi_int* lookup_mode, casadi_int m,
+                               casadi_int* iw, T1* w);
+
   // Multilinear interpolant - calculate gradient
   template<typename T1>
   void casadi_interpn_grad(T1* grad, casadi_int ndim, const T1* grid, const casadi_int* offset,
@@ -175,6 +182,14 @@ namespace casadi {
                             const T1* x, const casadi_int* lookup_mode, casadi_int reverse,
                             casadi_int* iw, T1* w);
 
+  // De boor nd evaluation - calculate value and gradient in one pass
+  template<typename T1>
+  void casadi_nd_boor_val_grad(T1* ret, T1* grad, casadi_int n_dims, const T1* knots,
+                               const casadi_int* offset, const casadi_int* degree,
+                               const casadi_int* strides, const T1* c, casadi_int m,
+                               const T1* x, const casadi_int* lookup_mode,
+                               casadi_int* iw, T1* w);
+
 
   template<typename T1>
   T1 casadi_mmax(const T1* x, casadi_int n, casadi_int is_dense);
@@ -229,9 +244,11 @@ namespace casadi {
   #include "casadi_polyval.hpp"
   #include "casadi_de_boor.hpp"
   #include "casadi_nd_boor_eval.hpp"
+  #include "casadi_nd_boor_val_grad.hpp"
   #include "casadi_interpn_weights.hpp"
   #include "casadi_interpn_interpolate.hpp"
   #include "casadi_interpn.hpp"
+  #include "casadi_interpn_val_grad.hpp"
   #include "casadi_interpn_grad.hpp"
   #include "casadi_mv_dense.hpp"
   #include "casadi_finite_diff.hpp"
@@ -240,6 +257,7 @@ namespace casadi {
   #include "casadi_bfgs.hpp"
   #include "casadi_regularize.hpp"
   #include "casadi_newton.hpp"
+  #include "casadi_bound_consistency.hpp"
 } // namespace casadi
 
 /// \endcond
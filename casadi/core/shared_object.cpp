@@ -29,9 +29,22 @@
 #endif // WITH_EXTRA_CHECKS
 #include <typeinfo>
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
+
 using namespace std;
 namespace casadi {
 
+#ifdef CASADI_WITH_THREAD
+  // Protects weak references against the concurrent destruction of the object
+  std::mutex mutex_weak_ref;
+#endif //CASADI_WITH_THREAD
+
   // Instantiate templates
   template class SparseStorage<WeakRef>;
 
@@ -145,9 +158,21 @@ namespace casadi {
 
   SharedObject WeakRef::shared() {
     SharedObject ret;
+#ifdef CASADI_WITH_THREAD
+    // The last owning reference may be released by another thread: only add a
+    // reference while there is one, the destructor then waits for the mutex
+    std::lock_guard<std::mutex> lock(mutex_weak_ref);
+    if (alive()) {
+      SharedObjectInternal* raw = (*this)->raw_;
+      casadi_int c = raw->count;
+      while (c>0 && !raw->count.compare_exchange_weak(c, c+1)) {}
+      if (c>0) ret.assign(raw);
+    }
+#else // CASADI_WITH_THREAD
     if (alive()) {
       ret.own((*this)->raw_);
     }
+#endif // CASADI_WITH_THREAD
     return ret;
   }
 
@@ -24,9 +24,22 @@
 
 #include "shared_object_internal.hpp"
 
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
+
 using namespace std;
 namespace casadi {
 
+#ifdef CASADI_WITH_THREAD
+  // Defined in shared_object.cpp
+  extern std::mutex mutex_weak_ref;
+#endif //CASADI_WITH_THREAD
+
   SharedObjectInternal::SharedObjectInternal(const SharedObjectInternal& node) {
     count = 0; // reference counter is _not_ copied
     weak_ref_ = nullptr; // nor will they have the same weak references
@@ -51,6 +64,9 @@ namespace casadi {
     }
     #endif // WITH_REFCOUNT_WARNINGS
     if (weak_ref_!=nullptr) {
+#ifdef CASADI_WITH_THREAD
+      std::lock_guard<std::mutex> lock(mutex_weak_ref);
+#endif //CASADI_WITH_THREAD
       weak_ref_->kill();
       delete weak_ref_;
     }
@@ -61,6 +77,9 @@ namespace casadi {
   }
 
   WeakRef* SharedObjectInternal::weak() {
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(mutex_weak_ref);
+#endif //CASADI_WITH_THREAD
     if (weak_ref_==nullptr) {
       weak_ref_ = new WeakRef(this);
     }
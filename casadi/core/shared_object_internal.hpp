@@ -27,6 +27,9 @@
 #define CASADI_SHARED_OBJECT_INTERNAL_HPP
 
 #include "shared_object.hpp"
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#endif //CASADI_WITH_THREAD
 
 namespace casadi {
 
@@ -34,6 +37,7 @@ namespace casadi {
   /// Internal class for the reference counting framework, see comments on the public class.
   class CASADI_EXPORT SharedObjectInternal {
     friend class SharedObject;
+    friend class WeakRef;
     friend class Memory;
   public:
 
@@ -83,7 +87,11 @@ namespace casadi {
 
   private:
     /// Number of references pointing to the object
+#ifdef CASADI_WITH_THREAD
+    std::atomic<casadi_int> count;
+#else // CASADI_WITH_THREAD
     casadi_int count;
+#endif // CASADI_WITH_THREAD
 
     /// Weak pointer (non-owning) object for the object
     WeakRef* weak_ref_;
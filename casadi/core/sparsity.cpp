@@ -28,7 +28,15 @@
 #include "matrix.hpp"
 #include "casadi_misc.hpp"
 #include "sparse_storage_impl.hpp"
+#include "perf_counters.hpp"
 #include <climits>
+#ifdef CASADI_WITH_THREAD
+#ifdef CASADI_WITH_THREAD_MINGW
+#include <mingw.mutex.h>
+#else // CASADI_WITH_THREAD_MINGW
+#include <mutex>
+#endif // CASADI_WITH_THREAD_MINGW
+#endif //CASADI_WITH_THREAD
 
 #define CASADI_THROW_ERROR(FNAME, WHAT) \
 throw CasadiException("Error in Sparsity::" FNAME " at " + CASADI_WHERE + ":\n"\
@@ -40,6 +48,11 @@ namespace casadi {
   // Instantiate templates
   template class SparseStorage<Sparsity>;
 
+#ifdef CASADI_WITH_THREAD
+  // Protects the cache of sparsity patterns
+  std::mutex mutex_sparsity_cache;
+#endif //CASADI_WITH_THREAD
+
   /// \cond INTERNAL
   // Singletons
   class EmptySparsity : public Sparsity {
@@ -848,6 +861,10 @@ namespace casadi {
     // Hash the pattern
     std::size_t h = hash_sparsity(nrow, ncol, colind, row);
 
+#ifdef CASADI_WITH_THREAD
+    std::lock_guard<std::mutex> lock(mutex_sparsity_cache);
+#endif //CASADI_WITH_THREAD
+
     // Get a reference to the cache
     CachingMap& cache = getCache();
 
@@ -866,17 +883,18 @@ namespace casadi {
         // Get a weak reference to the cached sparsity pattern
         WeakRef& wref = i->second;
 
-        // Check if the pattern still exists
-        if (wref.alive()) {
+        // Get an owning reference to the cached pattern, null if it no longer exists
+        Sparsity ref = shared_cast<Sparsity>(wref.shared());
 
-          // Get an owning reference to the cached pattern
-          Sparsity ref = shared_cast<Sparsity>(wref.shared());
+        // Check if the pattern still exists
+        if (!ref.is_null()) {
 
           // Check if the pattern matches
           if (ref.is_equal(nrow, ncol, colind, row)) {
 
             // Found match!
             own(ref.get());
+            PerfCounters::count(PerfCounters::SPARSITY_CACHE_HIT);
             return;
 
           } else { // There is a hash rowision (unlikely, but possible)
@@ -895,8 +913,9 @@ namespace casadi {
               Sparsity ref = shared_cast<Sparsity>(j->second.shared());
 
               // Match found if sparsity matches
-              if (ref.is_equal(nrow, ncol, colind, row)) {
+              if (!ref.is_null() && ref.is_equal(nrow, ncol, colind, row)) {
                 own(ref.get());
+                PerfCounters::count(PerfCounters::SPARSITY_CACHE_HIT);
                 return;
               }
             }
@@ -904,6 +923,7 @@ namespace casadi {
 
           // The cached entry has been deleted, create a new one
           own(new SparsityInternal(nrow, ncol, colind, row));
+          PerfCounters::count(PerfCounters::SPARSITY_CACHE_MISS);
 
           // Cache this pattern
           wref = *this;
@@ -916,6 +936,7 @@ namespace casadi {
 
     // No matching sparsity pattern could be found, create a new one
     own(new SparsityInternal(nrow, ncol, colind, row));
+    PerfCounters::count(PerfCounters::SPARSITY_CACHE_MISS);
 
     // Cache this pattern
     cache.insert(std::pair<std::size_t, WeakRef>(h, *this));
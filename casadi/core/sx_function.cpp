@@ -36,6 +36,10 @@
 #include "sparsity_internal.hpp"
 #include "global_options.hpp"
 #include "casadi_interrupt.hpp"
+#include "constant_sx.hpp"
+#include "symbolic_sx.hpp"
+#include "unary_sx.hpp"
+#include "binary_sx.hpp"
 
 namespace casadi {
 
@@ -55,6 +59,7 @@ namespace casadi {
   }
 
   SXFunction::~SXFunction() {
+    clear_mem();
   }
 
   int SXFunction::eval(const double** arg, double** res,
@@ -72,19 +77,60 @@ namespace casadi {
     // NOTE: The implementation of this function is very delicate. Small changes in the
     // class structure can cause large performance losses. For this reason,
     // the preprocessor macros are used below
+#define CASADI_SX_EVAL_INSTRUCTION(e) \
+    switch (e.op) { \
+      CASADI_MATH_FUN_BUILTIN(w[e.i1], w[e.i2], w[e.i0]) \
+    case OP_CONST: w[e.i0] = e.d; break; \
+    case OP_INPUT: w[e.i0] = arg[e.i1]==nullptr ? 0 : arg[e.i1][e.i2]; break; \
+    case OP_OUTPUT: if (res[e.i0]!=nullptr) res[e.i0][e.i2] = w[e.i1]; break; \
+    default: \
+      casadi_error("Unknown operation" + str(e.op)); \
+    }
 
-    // Evaluate the algorithm
-    for (auto&& e : algorithm_) {
-      switch (e.op) {
-        CASADI_MATH_FUN_BUILTIN(w[e.i1], w[e.i2], w[e.i0])
+    // Incremental evaluation: only re-execute the instructions depending on changed inputs
+    XFunctionMemoryLock lock(incremental_ ? mem : nullptr);
+    if (lock.get()) {
+      XFunctionMemory* m = lock.get();
+      uint64_t chg = changed_inputs(arg, m);
+      w = get_ptr(m->w);
+      if (chg==~uint64_t(0)) {
+        // Also the instructions not depending on any input
+        for (auto&& e : algorithm_) {
+          CASADI_SX_EVAL_INSTRUCTION(e)
+        }
+        m->n_exec = algorithm_.size();
+      } else {
+        const uint64_t* dep = get_ptr(in_dep_);
+        m->n_exec = 0;
+        for (auto&& e : algorithm_) {
+          if ((*dep++ & chg) || e.op==OP_OUTPUT) {
+            CASADI_SX_EVAL_INSTRUCTION(e)
+            m->n_exec++;
+          }
+        }
+      }
+      m->valid = true;
+      return 0;
+    }
 
-      case OP_CONST: w[e.i0] = e.d; break;
-      case OP_INPUT: w[e.i0] = arg[e.i1]==nullptr ? 0 : arg[e.i1][e.i2]; break;
-      case OP_OUTPUT: if (res[e.i0]!=nullptr) res[e.i0][e.i2] = w[e.i1]; break;
-      default:
-        casadi_error("Unknown operation" + str(e.op));
+    // Only a subset of the outputs requested: skip the instructions not needed
+    uint64_t req;
+    if (prune(res, req)) {
+      if (!(req & demand_all_)) return 0;
+      const uint64_t* dep = get_ptr(out_dep_);
+      for (auto&& e : algorithm_) {
+        if (*dep++ & req) {
+          CASADI_SX_EVAL_INSTRUCTION(e)
+        }
       }
+      return 0;
     }
+
+    // Evaluate the algorithm
+    for (auto&& e : algorithm_) {
+      CASADI_SX_EVAL_INSTRUCTION(e)
+    }
+#undef CASADI_SX_EVAL_INSTRUCTION
     return 0;
   }
 
@@ -190,7 +236,14 @@ namespace casadi {
         "Just-in-time compilation for numeric evaluation using OpenCL (experimental)"}},
       {"live_variables",
        {OT_BOOL,
-        "Reuse variables in the work vector"}}
+        "Reuse variables in the work vector"}},
+      {"incremental",
+       {OT_BOOL,
+        "Keep the intermediate results in the memory object and only "
+        "re-execute the instructions depending on inputs that changed "
+        "since the last evaluation. Disables live_variables. Evaluations "
+        "with a memory object in use, e.g. by another thread, recalculate "
+        "everything. The stats entry n_exec counts the instructions executed."}}
      }
   };
 
@@ -212,9 +265,14 @@ namespace casadi {
         just_in_time_opencl_ = op.second;
       } else if (op.first=="just_in_time_sparsity") {
         just_in_time_sparsity_ = op.second;
+      } else if (op.first=="incremental") {
+        incremental_ = op.second;
       }
     }
 
+    // Intermediate results must not be overwritten in incremental evaluation
+    if (incremental_) live_variables = false;
+
     // Check/set default inputs
     if (default_in_.empty()) {
       default_in_.resize(n_in_, 0);
@@ -448,6 +506,47 @@ namespace casadi {
       }
     }
 
+    // Outputs depending on each instruction, found in a backward sweep over the
+    // algorithm. The demand of a work vector element is reset where it is assigned,
+    // since the element may be reused by the live variable algorithm.
+    out_dep_.clear();
+    if (n_out_>1) {
+      out_dep_.resize(algorithm_.size());
+      vector<uint64_t> demand(worksize_, 0);
+      for (casadi_int k=algorithm_.size()-1; k>=0; --k) {
+        const AlgEl& e = algorithm_[k];
+        if (e.op==OP_OUTPUT) {
+          out_dep_[k] = mask_bit(e.i0);
+          demand[e.i1] |= out_dep_[k];
+        } else {
+          out_dep_[k] = demand[e.i0];
+          demand[e.i0] = 0;
+          if (e.op!=OP_CONST && e.op!=OP_INPUT && e.op!=OP_PARAMETER) {
+            // Unary operations have i2==i1
+            demand[e.i1] |= out_dep_[k];
+            demand[e.i2] |= out_dep_[k];
+          }
+        }
+      }
+    }
+
+    // Inputs each instruction depends on, found in a forward sweep over the algorithm
+    in_dep_.clear();
+    if (incremental_) {
+      in_dep_.resize(algorithm_.size());
+      vector<uint64_t> dep(worksize_, 0);
+      for (casadi_int k=0; k<algorithm_.size(); ++k) {
+        const AlgEl& e = algorithm_[k];
+        switch (e.op) {
+        case OP_OUTPUT: in_dep_[k] = dep[e.i1]; break;
+        case OP_INPUT: in_dep_[k] = dep[e.i0] = mask_bit(e.i1); break;
+        case OP_CONST:
+        case OP_PARAMETER: in_dep_[k] = dep[e.i0] = 0; break;
+        default: in_dep_[k] = dep[e.i0] = dep[e.i1] | dep[e.i2];
+        }
+      }
+    }
+
     // Initialize just-in-time compilation for numeric evaluation using OpenCL
     if (just_in_time_opencl_) {
       casadi_error("OpenCL is not supported in this version of CasADi");
@@ -809,6 +908,31 @@ namespace casadi {
                                   SX, SXNode>::is_a(type, recursive));
   }
 
+  Dict SXFunction::memory_footprint() const {
+    Dict fp = FunctionInternal::memory_footprint();
+
+    // Instruction tape
+    add_footprint(fp, "algorithm", algorithm_.capacity()*sizeof(AlgEl)
+                  + (out_dep_.capacity() + in_dep_.capacity())*sizeof(uint64_t));
+
+    // Constants
+    add_footprint(fp, "constants", constants_.size()*sizeof(ConstantSX));
+
+    // Expression graph nodes
+    Dict nodes;
+    size_t n_op = 0, n_sym = 0;
+    for (auto&& e : operations_) {
+      n_op += casadi_math<double>::ndeps(e.op())==2 ? sizeof(BinarySX) : sizeof(UnarySX);
+    }
+    for (auto&& e : in_) n_sym += e.nnz();
+    n_sym += free_vars_.size();
+    nodes["count"] = static_cast<casadi_int>(operations_.size() + constants_.size() + n_sym);
+    add_footprint(nodes, "operations", n_op);
+    add_footprint(nodes, "symbolic", n_sym*sizeof(SymbolicSX));
+    add_footprint(fp, "nodes", nodes);
+    return fp;
+  }
+
   Function SXFunction::deserialize(std::istream &stream) {
 
     // Read in information from header
@@ -91,6 +91,9 @@ class CASADI_EXPORT SXFunction :
   /** \brief Check if the function is of a particular type */
   bool is_a(const std::string& type, bool recursive) const override;
 
+  /** \brief Estimate the memory used, in bytes */
+  Dict memory_footprint() const override;
+
   ///@{
   /** \brief Get function input(s) and output(s)  */
   const SX sx_in(casadi_int ind) const override;
@@ -170,6 +173,14 @@ class CASADI_EXPORT SXFunction :
   // Work vector size
   size_t worksize_;
 
+  /** \brief Demand masks: the outputs depending on each instruction,
+   * only for functions with multiple outputs */
+  std::vector<uint64_t> out_dep_;
+
+  /** \brief Dependency masks: the inputs each instruction depends on,
+   * only for incremental evaluation */
+  std::vector<uint64_t> in_dep_;
+
   /// Free variables
   std::vector<SXElem> free_vars_;
 
@@ -27,6 +27,7 @@
 #define CASADI_X_FUNCTION_HPP
 
 #include <stack>
+#include <cstring>
 #include "function_internal.hpp"
 #include "factory.hpp"
 
@@ -44,6 +45,48 @@ throw CasadiException("Error in XFunction::" FNAME " for '" + this->name_ + "' "
 
 namespace casadi {
 
+  /** \brief Memory for incremental evaluation of SXFunction and MXFunction */
+  struct CASADI_EXPORT XFunctionMemory {
+    /// Work vector, kept between evaluations
+    std::vector<double> w;
+
+    /// Input nonzeros of the last evaluation
+    std::vector<double> arg;
+
+    /// Is the work vector consistent with the stored inputs?
+    bool valid;
+
+    /// Number of instructions executed in the last incremental evaluation
+    casadi_int n_exec;
+
+#ifdef CASADI_WITH_THREAD
+    /// Held during an incremental evaluation
+    std::mutex mtx;
+#endif // CASADI_WITH_THREAD
+  };
+
+  /** \brief Exclusive use of the memory block of an incremental evaluation
+   *
+   * get() is null if the memory block is in use, e.g. memory 0 of a function
+   * evaluated from several threads. The evaluation then recalculates everything.
+   */
+  class CASADI_EXPORT XFunctionMemoryLock {
+  public:
+    explicit XFunctionMemoryLock(void* mem) : m_(static_cast<XFunctionMemory*>(mem)) {
+#ifdef CASADI_WITH_THREAD
+      if (m_ && !m_->mtx.try_lock()) m_ = nullptr;
+#endif // CASADI_WITH_THREAD
+    }
+    ~XFunctionMemoryLock() {
+#ifdef CASADI_WITH_THREAD
+      if (m_) m_->mtx.unlock();
+#endif // CASADI_WITH_THREAD
+    }
+    XFunctionMemory* get() const { return m_;}
+  private:
+    XFunctionMemory* m_;
+  };
+
   /** \brief  Internal node class for the base class of SXFunction and MXFunction
       (lacks a public counterpart)
       The design of the class uses the curiously recurring template pattern (CRTP) idiom
@@ -192,6 +235,45 @@ namespace casadi {
     Sparsity get_sparsity_out(casadi_int i) override { return out_.at(i).sparsity();}
     /// @}
 
+    /** \brief Bit of an input or output in a dependency mask,
+     * indices beyond 63 share the last bit */
+    static uint64_t mask_bit(casadi_int ind) {
+      return uint64_t(1) << std::min(ind, casadi_int(63));
+    }
+
+    /** \brief Outputs requested in a numerical evaluation, as a demand mask
+     *
+     * Returns true if some output with nonzeros is not requested, i.e. if
+     * instructions not needed for the requested outputs can be skipped
+     */
+    bool prune(double** res, uint64_t& req) const {
+      req = 0;
+      for (casadi_int i=0; i<n_out_; ++i) if (res[i]) req |= mask_bit(i);
+      return (req & demand_all_) != demand_all_;
+    }
+
+    /** \brief Create memory block, only for incremental evaluation */
+    void* alloc_mem() const override { return incremental_ ? new XFunctionMemory() : nullptr;}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<XFunctionMemory*>(mem);}
+
+    /** \brief Bytes allocated by a memory block */
+    size_t mem_footprint(void* mem) const override;
+
+    /** \brief Get all statistics */
+    Dict get_stats(void* mem) const override;
+
+    /** \brief Inputs that changed since the last incremental evaluation, as a mask
+     *
+     * All bits are set if everything needs to be calculated. The new inputs are
+     * stored and the memory block is marked as invalid until the evaluation has completed
+     */
+    uint64_t changed_inputs(const double** arg, XFunctionMemory* m) const;
+
     // Data members (all public)
 
     /** \brief  Inputs of the function (needed for symbolic calculations) */
@@ -199,6 +281,12 @@ namespace casadi {
 
     /** \brief  Outputs of the function (needed for symbolic calculations) */
     std::vector<MatType> out_;
+
+    /** \brief Demand mask of all outputs with nonzeros */
+    uint64_t demand_all_;
+
+    /** \brief Keep intermediate results between evaluations */
+    bool incremental_;
   };
 
   // Template implementations
@@ -210,7 +298,7 @@ namespace casadi {
             const std::vector<MatType>& ex_out,
             const std::vector<std::string>& name_in,
             const std::vector<std::string>& name_out)
-    : FunctionInternal(name), in_(ex_in),  out_(ex_out) {
+    : FunctionInternal(name), in_(ex_in),  out_(ex_out), demand_all_(0), incremental_(false) {
     // Names of inputs
     if (!name_in.empty()) {
       casadi_assert(ex_in.size()==name_in.size(),
@@ -259,6 +347,65 @@ namespace casadi {
       }
       casadi_error(s.str());
     }
+
+    // Outputs that need to be requested for a full evaluation
+    demand_all_ = 0;
+    for (casadi_int i=0; i<n_out_; ++i) {
+      if (nnz_out(i)>0) demand_all_ |= mask_bit(i);
+    }
+  }
+
+  template<typename DerivedType, typename MatType, typename NodeType>
+  int XFunction<DerivedType, MatType, NodeType>::init_mem(void* mem) const {
+    if (FunctionInternal::init_mem(mem)) return 1;
+    if (!incremental_) return 0;
+    auto m = static_cast<XFunctionMemory*>(mem);
+    m->w.resize(sz_w());
+    m->arg.resize(nnz_in());
+    m->valid = false;
+    m->n_exec = 0;
+    return 0;
+  }
+
+  template<typename DerivedType, typename MatType, typename NodeType>
+  Dict XFunction<DerivedType, MatType, NodeType>::get_stats(void* mem) const {
+    Dict stats = FunctionInternal::get_stats(mem);
+    if (incremental_) {
+      auto m = static_cast<XFunctionMemory*>(mem);
+      stats["n_exec"] = m->n_exec;
+    }
+    return stats;
+  }
+
+  template<typename DerivedType, typename MatType, typename NodeType>
+  size_t XFunction<DerivedType, MatType, NodeType>::mem_footprint(void* mem) const {
+    auto m = static_cast<XFunctionMemory*>(mem);
+    return (m->w.capacity() + m->arg.capacity())*sizeof(double);
+  }
+
+  template<typename DerivedType, typename MatType, typename NodeType>
+  uint64_t XFunction<DerivedType, MatType, NodeType>::
+  changed_inputs(const double** arg, XFunctionMemory* m) const {
+    // Everything needs to be calculated after a failed or no previous evaluation
+    uint64_t chg = m->valid ? 0 : ~uint64_t(0);
+    double* a = get_ptr(m->arg);
+    for (casadi_int i=0; i<n_in_; ++i) {
+      casadi_int nnz = nnz_in(i);
+      if (nnz==0) continue;
+      // A missing input is zero
+      bool changed;
+      if (arg[i]) {
+        changed = std::memcmp(arg[i], a, nnz*sizeof(double))!=0;
+        if (changed) std::copy(arg[i], arg[i]+nnz, a);
+      } else {
+        changed = std::any_of(a, a+nnz, [](double v) { return v!=0;});
+        if (changed) std::fill(a, a+nnz, 0);
+      }
+      if (changed) chg |= mask_bit(i);
+      a += nnz;
+    }
+    m->valid = false;
+    return chg;
   }
 
   template<typename DerivedType, typename MatType, typename NodeType>
@@ -27,7 +27,13 @@
 #include "casadi/core/casadi_misc.hpp"
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#ifdef __linux__
+#include <unistd.h>
+#endif
 using namespace std;
 namespace casadi {
 
@@ -60,7 +66,14 @@ namespace casadi {
   = {{&Nlpsol::options_},
      {{"solver",
        {OT_STRING,
-        "AMPL solver binary"}}
+        "AMPL solver binary"}},
+      {"nl_format",
+       {OT_STRING,
+        "Format of the .nl file: 'binary' (default) or 'text'"}},
+      {"tmp_dir",
+       {OT_STRING,
+        "Directory for the .nl, .sol and output files. "
+        "Default: /dev/shm where available, otherwise the working directory"}}
      }
   };
 
@@ -70,13 +83,31 @@ namespace casadi {
 
     // Set default options
     solver_ = "ipopt";
+    binary_ = true;
+    tmp_dir_.clear();
+#ifdef __linux__
+    // RAM-backed file system
+    if (access("/dev/shm", W_OK)==0) tmp_dir_ = "/dev/shm";
+#endif
 
     // Read user options
     for (auto&& op : opts) {
       if (op.first=="solver") {
-        solver_ = op.first;
+        solver_ = op.second.to_string();
+      } else if (op.first=="nl_format") {
+        string nl_format = op.second;
+        if (nl_format=="binary") {
+          binary_ = true;
+        } else if (nl_format=="text") {
+          binary_ = false;
+        } else {
+          casadi_error("Unknown 'nl_format': " + nl_format + ". Use 'binary' or 'text'");
+        }
+      } else if (op.first=="tmp_dir") {
+        tmp_dir_ = op.second.to_string();
       }
     }
+    if (!tmp_dir_.empty() && tmp_dir_.back()!='/') tmp_dir_ += "/";
 
     // Extract the expressions
     casadi_assert(oracle().is_a("SXFunction"),
@@ -108,8 +139,8 @@ namespace casadi {
     f = ex[0];
     g = ex[1];
 
-    // Header
-    nl_init_ << "g3 1 1 0\n";
+    // Header, text also for the binary format
+    nl_init_ << (binary_ ? "b" : "g") << "3 1 1 0\n";
     // Type of constraints
     nl_init_ << nx_ << " " // number of variables
        << ng_ << " " // number of constraints
@@ -131,10 +162,14 @@ namespace casadi {
        << nx_ << " " // in objectives
        << nx_ << "\n"; // in both
 
+    // Byte order of binary data: 1 for little endian, 2 for big endian
+    int one = 1;
+    int arith = !binary_ ? 0 : *reinterpret_cast<char*>(&one)==1 ? 1 : 2;
+
     // Linear network ..
     nl_init_ << 0 << " " // .. variables ..
-       << 0 << " " // .. arith ..
        << 0 << " " // .. functions ..
+       << arith << " " // .. arithmetic ..
        << 0 << "\n"; // .. flags
 
     // Discrete variables
@@ -180,49 +215,50 @@ namespace casadi {
       if (i.size()>1) i1 = i[1];
       switch (op) {
         case OP_CONST:
-        work[o0] = "n" + str(F.instruction_constant(k)) + "\n";
+        work[o0] = nl_num(F.instruction_constant(k));
         break;
         case OP_INPUT:
-        work[o0] = "v" + str(i0*v.size() + i1) + "\n";
+        // Common subexpressions are numbered after the variables
+        work[o0] = nl_seg('v', {i0==0 ? nx_ + i1 : i1});
         break;
         case OP_OUTPUT:
         if (o0==0) {
           // Common subexpression
-          nl_init_ << "V" << (x.nnz()+o1) << " 0 0\n" << work[i0];
+          nl_init_ << nl_seg('V', {nx_+o1, 0, 0}) << work[i0];
         } else if (o0==1) {
           // Nonlinear objective term
-          nl_init_ << "O" << o1 << " 0\n" << work[i0];
+          nl_init_ << nl_seg('O', {o1, 0}) << work[i0];
         } else {
           // Nonlinear constraint term
-          nl_init_ << "C" << o1 << "\n" << work[i0];
+          nl_init_ << nl_seg('C', {o1}) << work[i0];
         }
         break;
-        case OP_ADD: work[o0] = "o0\n" + work[i0] + work[i1]; break;
-        case OP_SUB: work[o0] = "o1\n" + work[i0] + work[i1]; break;
-        case OP_MUL: work[o0] = "o2\n" + work[i0] + work[i1]; break;
-        case OP_DIV: work[o0] = "o3\n" + work[i0] + work[i1]; break;
-        case OP_SQ: work[o0] = "o5\n" + work[i0] + "n2\n"; break;
-        case OP_POW: work[o0] = "o5\n" + work[i0] + work[i1]; break;
-        case OP_FLOOR: work[o0] = "o13\n" + work[i0]; break;
-        case OP_CEIL: work[o0] = "o14\n" + work[i0]; break;
-        case OP_FABS: work[o0] = "o15\n" + work[i0]; break;
-        case OP_NEG: work[o0] = "o16\n" + work[i0]; break;
-        case OP_TANH: work[o0] = "o37\n" + work[i0]; break;
-        case OP_TAN: work[o0] = "o38\n" + work[i0]; break;
-        case OP_SQRT: work[o0] = "o39\n" + work[i0]; break;
-        case OP_SINH: work[o0] = "o40\n" + work[i0]; break;
-        case OP_SIN: work[o0] = "o41\n" + work[i0]; break;
-        case OP_LOG: work[o0] = "o43\n" + work[i0]; break;
-        case OP_EXP: work[o0] = "o44\n" + work[i0]; break;
-        case OP_COSH: work[o0] = "o45\n" + work[i0]; break;
-        case OP_COS: work[o0] = "o46\n" + work[i0]; break;
-        case OP_ATANH: work[o0] = "o47\n" + work[i0]; break;
-        case OP_ATAN2: work[o0] = "o48\n" + work[i0] + work[i1]; break;
-        case OP_ATAN: work[o0] = "o49\n" + work[i0]; break;
-        case OP_ASINH: work[o0] = "o50\n" + work[i0]; break;
-        case OP_ASIN: work[o0] = "o51\n" + work[i0]; break;
-        case OP_ACOSH: work[o0] = "o52\n" + work[i0]; break;
-        case OP_ACOS: work[o0] = "o53\n" + work[i0]; break;
+        case OP_ADD: work[o0] = nl_seg('o', {0}) + work[i0] + work[i1]; break;
+        case OP_SUB: work[o0] = nl_seg('o', {1}) + work[i0] + work[i1]; break;
+        case OP_MUL: work[o0] = nl_seg('o', {2}) + work[i0] + work[i1]; break;
+        case OP_DIV: work[o0] = nl_seg('o', {3}) + work[i0] + work[i1]; break;
+        case OP_SQ: work[o0] = nl_seg('o', {5}) + work[i0] + nl_num(2); break;
+        case OP_POW: work[o0] = nl_seg('o', {5}) + work[i0] + work[i1]; break;
+        case OP_FLOOR: work[o0] = nl_seg('o', {13}) + work[i0]; break;
+        case OP_CEIL: work[o0] = nl_seg('o', {14}) + work[i0]; break;
+        case OP_FABS: work[o0] = nl_seg('o', {15}) + work[i0]; break;
+        case OP_NEG: work[o0] = nl_seg('o', {16}) + work[i0]; break;
+        case OP_TANH: work[o0] = nl_seg('o', {37}) + work[i0]; break;
+        case OP_TAN: work[o0] = nl_seg('o', {38}) + work[i0]; break;
+        case OP_SQRT: work[o0] = nl_seg('o', {39}) + work[i0]; break;
+        case OP_SINH: work[o0] = nl_seg('o', {40}) + work[i0]; break;
+        case OP_SIN: work[o0] = nl_seg('o', {41}) + work[i0]; break;
+        case OP_LOG: work[o0] = nl_seg('o', {43}) + work[i0]; break;
+        case OP_EXP: work[o0] = nl_seg('o', {44}) + work[i0]; break;
+        case OP_COSH: work[o0] = nl_seg('o', {45}) + work[i0]; break;
+        case OP_COS: work[o0] = nl_seg('o', {46}) + work[i0]; break;
+        case OP_ATANH: work[o0] = nl_seg('o', {47}) + work[i0]; break;
+        case OP_ATAN2: work[o0] = nl_seg('o', {48}) + work[i0] + work[i1]; break;
+        case OP_ATAN: work[o0] = nl_seg('o', {49}) + work[i0]; break;
+        case OP_ASINH: work[o0] = nl_seg('o', {50}) + work[i0]; break;
+        case OP_ASIN: work[o0] = nl_seg('o', {51}) + work[i0]; break;
+        case OP_ACOSH: work[o0] = nl_seg('o', {52}) + work[i0]; break;
+        case OP_ACOS: work[o0] = nl_seg('o', {53}) + work[i0]; break;
         default:
         if (casadi_math<double>::ndeps(op)==1) {
           casadi_error(casadi_math<double>::print(op, "x") + " not supported");
@@ -234,30 +270,155 @@ namespace casadi {
 
     // k segments, cumulative column count in jac_g
     const casadi_int *colind = jac_g.colind(), *row = jac_g.row();
-    nl_init_ << "k" << (nx_-1) << "\n";
-    for (casadi_int i=1; i<nx_; ++i) nl_init_ << colind[i] << "\n";
+    nl_init_ << nl_seg('k', {nx_-1});
+    for (casadi_int i=1; i<nx_; ++i) nl_init_ << nl_int(colind[i]);
 
     // J segments, rows in jac_g
     Sparsity sp = jac_g.T();
     colind = sp.colind(), row = sp.row();
     for (casadi_int i=0; i<ng_; ++i) {
-      nl_init_ << "J" << i << " " << (colind[i+1]-colind[i]) << "\n";
+      nl_init_ << nl_seg('J', {i, colind[i+1]-colind[i]});
       for (casadi_int k=colind[i]; k<colind[i+1]; ++k) {
         casadi_int r=row[k];
-        nl_init_ << r << " " << 0 << "\n"; // no linear term
+        nl_init_ << nl_pair(r, 0); // no linear term
       }
     }
 
     // G segments, rows in jac_f
     sp = jac_f.T();
     colind = sp.colind(), row = sp.row();
-    nl_init_ << "G" << 0 << " " << (colind[0+1]-colind[0]) << "\n";
+    nl_init_ << nl_seg('G', {0, colind[0+1]-colind[0]});
     for (casadi_int k=colind[0]; k<colind[0+1]; ++k) {
       casadi_int r=row[k];
-      nl_init_ << r << " " << 0 << "\n"; // no linear term
+      nl_init_ << nl_pair(r, 0); // no linear term
+    }
+    nl_init_size_ = nl_init_.str().size();
+  }
+
+  string AmplInterface::nl_seg(char key, const vector<casadi_int>& v) const {
+    string ret(1, key);
+    if (binary_) {
+      for (casadi_int e : v) ret += nl_int(e);
+    } else {
+      for (casadi_int k=0; k<v.size(); ++k) ret += (k==0 ? "" : " ") + str(v[k]);
+      ret += "\n";
+    }
+    return ret;
+  }
+
+  string AmplInterface::nl_int(casadi_int v) const {
+    if (binary_) {
+      int e = static_cast<int>(v);
+      return string(reinterpret_cast<const char*>(&e), sizeof(e));
+    } else {
+      return str(v) + "\n";
+    }
+  }
+
+  // Text representation of a real number, without loss of precision
+  static string nl_str(double v) {
+    stringstream ss;
+    ss << setprecision(numeric_limits<double>::digits10 + 2) << v;
+    return ss.str();
+  }
+
+  string AmplInterface::nl_num(double v) const {
+    if (binary_) {
+      return "n" + string(reinterpret_cast<const char*>(&v), sizeof(v));
+    } else {
+      return "n" + nl_str(v) + "\n";
+    }
+  }
+
+  string AmplInterface::nl_pair(casadi_int i, double v) const {
+    if (binary_) {
+      int e = static_cast<int>(i);
+      return string(reinterpret_cast<const char*>(&e), sizeof(e))
+        + string(reinterpret_cast<const char*>(&v), sizeof(v));
+    } else {
+      return str(i) + " " + nl_str(v) + "\n";
+    }
+  }
+
+  string AmplInterface::nl_bound(double lb, double ub) const {
+    if (binary_) {
+      // Always a range, so that the segment has a fixed length
+      return "0" + string(reinterpret_cast<const char*>(&lb), sizeof(lb))
+        + string(reinterpret_cast<const char*>(&ub), sizeof(ub));
+    }
+    if (isinf(lb)) {
+      if (isinf(ub)) { // no constraint
+        return "3\n";
+      } else { // only upper
+        return "1 " + nl_str(ub) + "\n";
+      }
+    } else {
+      if (isinf(ub)) { // only lower
+        return "2 " + nl_str(lb) + "\n";
+      } else if (ub==lb) { // equality
+        return "4 " + nl_str(lb) + "\n";
+      } else { // range
+        return "0 " + nl_str(lb) + " " + nl_str(ub) + "\n";
+      }
     }
   }
 
+  string AmplInterface::nl_x(const double* x0) const {
+    string ret = nl_seg('x', {nx_});
+    for (casadi_int i=0; i<nx_; ++i) ret += nl_pair(i, x0[i]);
+    return ret;
+  }
+
+  string AmplInterface::nl_r(const double* lbg, const double* ubg) const {
+    string ret = nl_seg('r');
+    for (casadi_int i=0; i<ng_; ++i) ret += nl_bound(lbg ? lbg[i] : 0, ubg ? ubg[i] : 0);
+    return ret;
+  }
+
+  string AmplInterface::nl_b(const double* lbx, const double* ubx) const {
+    string ret = nl_seg('b');
+    for (casadi_int i=0; i<nx_; ++i) ret += nl_bound(lbx ? lbx[i] : 0, ubx ? ubx[i] : 0);
+    return ret;
+  }
+
+  void AmplInterface::write_nl(AmplInterfaceMemory* m) const {
+    // Segments that may change between calls, in the order of the file
+    vector<string> seg = {nl_x(m->x), nl_r(m->lbg, m->ubg), nl_b(m->lbx, m->ubx)};
+
+    if (m->nlname.empty()) {
+      // Write the complete file
+      m->nlname = temporary_file(tmp_dir_ + "casadi_ampl_tmp", ".nl");
+      ofstream nl(m->nlname, ofstream::out | ofstream::binary);
+      casadi_assert(nl.is_open(), "Failed to open " + m->nlname);
+      nl << nl_init_.str();
+      for (auto&& e : seg) nl << e;
+      if (verbose_) casadi_message("Wrote " + m->nlname);
+    } else if (binary_) {
+      // Fixed length segments, overwrite the ones that changed
+      fstream nl(m->nlname, fstream::in | fstream::out | fstream::binary);
+      casadi_assert(nl.is_open(), "Failed to open " + m->nlname);
+      streamoff offset = nl_init_size_;
+      for (casadi_int k=0; k<seg.size(); ++k) {
+        casadi_assert_dev(seg[k].size()==m->segments[k].size());
+        if (seg[k]!=m->segments[k]) {
+          nl.seekp(offset);
+          nl.write(seg[k].data(), seg[k].size());
+          if (verbose_) casadi_message("Updated '" + seg[k].substr(0, 1) + "' segment of "
+                                       + m->nlname);
+        }
+        offset += seg[k].size();
+      }
+    } else if (seg!=m->segments) {
+      // Text segments change length, rewrite the file
+      ofstream nl(m->nlname, ofstream::out | ofstream::trunc);
+      casadi_assert(nl.is_open(), "Failed to open " + m->nlname);
+      nl << nl_init_.str();
+      for (auto&& e : seg) nl << e;
+      if (verbose_) casadi_message("Wrote " + m->nlname);
+    }
+    m->segments = seg;
+  }
+
   int AmplInterface::init_mem(void* mem) const {
     if (Nlpsol::init_mem(mem)) return 1;
     //auto m = static_cast<AmplInterfaceMemory*>(mem);
@@ -274,85 +435,29 @@ namespace casadi {
 
   }
 
-  int AmplInterface::solve(void* mem) const {
-    auto m = static_cast<AmplInterfaceMemory*>(mem);
-
-    // Create .nl file and add preamble
-    std::string nlname = temporary_file("casadi_ampl_tmp", ".nl");
-    ofstream nl(nlname, ofstream::out);
-    if (verbose_) casadi_message("Opened " + nlname);
-    nl << nl_init_.str();
-
-    // Primal intial guess
-    nl << "x" << nx_ << "\n";
-    for (casadi_int i=0; i<nx_; ++i) {
-      nl << i << " " << m->x[i] << "\n";
-    }
-
-
-    // Add constraint bounds
-    nl << "r\n";
-    for (casadi_int i=0; i<ng_; ++i) {
-      double lbg = m->lbg ? m->lbg[i] : 0;
-      double ubg = m->ubg ? m->ubg[i] : 0;
-      if (isinf(lbg)) {
-        if (isinf(ubg)) { // no constraint
-          nl << "3\n";
-        } else { // only upper
-          nl << "1 " << ubg <<  "\n";
-        }
-      } else {
-        if (isinf(ubg)) { // only lower
-          nl << "2 " << lbg << "\n";
-        } else if (ubg==lbg) { // equality
-          nl << "4 " << lbg << "\n";
-        } else { // range
-          nl << "0 " << lbg << " " << ubg << "\n";
-        }
-      }
+  AmplInterfaceMemory::~AmplInterfaceMemory() {
+    // The .nl file is kept between calls
+    if (!nlname.empty() && remove(nlname.c_str())!=0) {
+      casadi_warning("Failed to remove " + nlname);
     }
+  }
 
-    // Add variable bounds
-    nl << "b\n";
-    for (casadi_int i=0; i<nx_; ++i) {
-      double lbx = m->lbx ? m->lbx[i] : 0;
-      double ubx = m->ubx ? m->ubx[i] : 0;
-      if (isinf(lbx)) {
-        if (isinf(ubx)) { // no constraint
-          nl << "3\n";
-        } else { // only upper
-          nl << "1 " << ubx <<  "\n";
-        }
-      } else {
-        if (isinf(ubx)) { // only lower
-          nl << "2 " << lbx << "\n";
-        } else if (ubx==lbx) { // equality
-          nl << "4 " << lbx << "\n";
-        } else { // range
-          nl << "0 " << lbx << " " << ubx << "\n";
-        }
-      }
-    }
+  int AmplInterface::solve(void* mem) const {
+    auto m = static_cast<AmplInterfaceMemory*>(mem);
 
-    // Close file
-    nl.close();
+    // Create or update .nl file
+    write_nl(m);
 
     // Temporary name for the .sol file
-    std::string solname = temporary_file("casadi_ampl_tmp", ".sol");
+    std::string solname = temporary_file(tmp_dir_ + "casadi_ampl_tmp", ".sol");
 
     // Temporary name for the solver output
-    std::string outname = temporary_file("casadi_ampl_tmp", ".out");
+    std::string outname = temporary_file(tmp_dir_ + "casadi_ampl_tmp", ".out");
     // Call executable
-    string system_cmd = solver_ + " -o" + solname + " " + nlname + " > " + outname;
+    string system_cmd = solver_ + " -o" + solname + " " + m->nlname + " > " + outname;
     int ret = system(system_cmd.c_str());
     casadi_assert_dev(ret==0);
 
-    // Delete the nl file
-    if (remove(nlname.c_str())!=0) {
-      casadi_warning("Failed to remove " + nlname);
-    }
-    if (verbose_) casadi_message("Removed " + nlname);
-
     // Open .out file and dump to screen
     ifstream out(outname, ifstream::in);
     casadi_assert(out.is_open(), "Failed to open " + outname);
@@ -369,39 +474,97 @@ namespace casadi {
     }
     if (verbose_) casadi_message("Removed " + outname);
 
-    // Open .sol file
-    ifstream sol(solname, ifstream::in);
-    casadi_assert(sol.is_open(), "Failed to open " + solname);
-    if (verbose_) casadi_message("Opened " + solname);
+    // Get the solution
+    read_sol(m, solname);
 
-    // Get all the lines
-    vector<string> sol_lines;
-    while (!sol.eof()) {
-      getline(sol, line);
-      sol_lines.push_back(line);
+    // Delete .sol file
+    if (remove(solname.c_str())!=0) {
+      casadi_warning("Failed to remove " + solname);
     }
+    if (verbose_) casadi_message("Removed " + solname);
 
-    // Get the primal solution
-    for (casadi_int i=0; i<nx_; ++i) {
-      istringstream s(sol_lines.at(sol_lines.size()-nx_+i-1));
-      s >> m->x[i];
-    }
+    return 0;
+  }
 
-    // Get the dual solution
-    for (casadi_int i=0; i<ng_; ++i) {
-      istringstream s(sol_lines.at(sol_lines.size()-ng_-nx_+i-1));
-      s >> m->lam_g[i];
-      m->lam_g[i] *= -1;
+  void AmplInterface::read_sol(AmplInterfaceMemory* m, const std::string& solname) const {
+    // Read the whole .sol file
+    ifstream sol(solname, ifstream::in | ifstream::binary);
+    casadi_assert(sol.is_open(), "Failed to open " + solname);
+    if (verbose_) casadi_message("Opened " + solname);
+    stringstream ss;
+    ss << sol.rdbuf();
+    string buf = ss.str();
+
+    // Binary .sol files, as written by solvers reading a binary .nl file, consist of
+    // records, each enclosed by its length in bytes
+    vector<pair<size_t, size_t> > rec;
+    size_t pos = 0;
+    int len, len2;
+    while (pos + 2*sizeof(int) <= buf.size()) {
+      memcpy(&len, &buf[pos], sizeof(int));
+      if (len<0 || pos + 2*sizeof(int) + len > buf.size()) break;
+      memcpy(&len2, &buf[pos + sizeof(int) + len], sizeof(int));
+      if (len2!=len) break;
+      rec.push_back(make_pair(pos + sizeof(int), static_cast<size_t>(len)));
+      pos += 2*sizeof(int) + len;
     }
 
-    // Close and delete .sol file
-    sol.close();
-    if (remove(solname.c_str())!=0) {
-      casadi_warning("Failed to remove " + solname);
+    if (rec.size()>=2 && pos==buf.size()) {
+      // Binary format: message, options, dual solution, primal solution, objective number
+      // and status, suffixes. The options record ends with the number of constraints,
+      // the number of dual values written, the number of variables and the number of
+      // primal values written, which settle the records that follow
+      casadi_assert(rec[1].second>=4*sizeof(int) && rec[1].second%sizeof(int)==0,
+                    "Unexpected binary .sol file: options not found");
+      int cnt[4];
+      memcpy(cnt, &buf[rec[1].first + rec[1].second - 4*sizeof(int)], 4*sizeof(int));
+      casadi_assert(cnt[0]==ng_ && cnt[2]==nx_,
+                    "Unexpected binary .sol file: " + str(cnt[2]) + " variables and "
+                    + str(cnt[0]) + " constraints, expected " + str(nx_) + " and "
+                    + str(ng_));
+      casadi_assert(cnt[3]==nx_, "Binary .sol file holds no primal solution");
+      size_t k = 2;
+      if (cnt[1]>0) {
+        casadi_assert(cnt[1]==ng_ && k<rec.size() && rec[k].second==ng_*sizeof(double),
+                      "Unexpected binary .sol file: dual solution not found");
+        memcpy(m->lam_g, &buf[rec[k++].first], ng_*sizeof(double));
+      } else {
+        // Dual solution not provided by the solver
+        casadi_fill(m->lam_g, ng_, 0.);
+      }
+      casadi_assert(k<rec.size() && rec[k].second==nx_*sizeof(double),
+                    "Unexpected binary .sol file: primal solution not found");
+      memcpy(m->x, &buf[rec[k].first], nx_*sizeof(double));
+    } else {
+      // Text format, get all the lines
+      vector<string> sol_lines;
+      istringstream s_buf(buf);
+      string line;
+      while (!s_buf.eof()) {
+        getline(s_buf, line);
+        sol_lines.push_back(line);
+      }
+
+      // Skip trailing empty lines and the objective number and status
+      while (!sol_lines.empty() && (sol_lines.back().empty()
+             || sol_lines.back().compare(0, 5, "objno")==0)) sol_lines.pop_back();
+      casadi_assert(sol_lines.size()>=nx_+ng_, "Unexpected .sol file");
+
+      // Get the primal solution
+      for (casadi_int i=0; i<nx_; ++i) {
+        istringstream s(sol_lines.at(sol_lines.size()-nx_+i));
+        s >> m->x[i];
+      }
+
+      // Get the dual solution
+      for (casadi_int i=0; i<ng_; ++i) {
+        istringstream s(sol_lines.at(sol_lines.size()-ng_-nx_+i));
+        s >> m->lam_g[i];
+      }
     }
-    if (verbose_) casadi_message("Removed " + solname);
 
-    return 0;
+    // Sign convention
+    for (casadi_int i=0; i<ng_; ++i) m->lam_g[i] *= -1;
   }
 
 
@@ -44,6 +44,14 @@ namespace casadi {
   class AmplInterface;
 
   struct CASADI_NLPSOL_AMPL_EXPORT AmplInterfaceMemory : public NlpsolMemory {
+    // .nl file, kept between calls, empty if not yet written
+    std::string nlname;
+
+    // Segments with initial guess and bounds last written to the .nl file
+    std::vector<std::string> segments;
+
+    /// Destructor
+    ~AmplInterfaceMemory();
   };
 
   /** \brief \pluginbrief{Nlpsol,AmplInterface}
@@ -97,8 +105,35 @@ namespace casadi {
     // Solver binary
     std::string solver_;
 
+    // Write the .nl file in binary format
+    bool binary_;
+
+    // Directory for temporary files
+    std::string tmp_dir_;
+
     // Construction of the NL problem
     std::stringstream nl_init_;
+    casadi_int nl_init_size_;
+
+    ///@{
+    /** \brief Pieces of the .nl file, text or binary depending on the format */
+    std::string nl_seg(char key, const std::vector<casadi_int>& v=std::vector<casadi_int>()) const;
+    std::string nl_int(casadi_int v) const;
+    std::string nl_num(double v) const;
+    std::string nl_pair(casadi_int i, double v) const;
+    std::string nl_bound(double lb, double ub) const;
+    ///@}
+
+    /// Variable and constraint bounds, initial guess
+    std::string nl_x(const double* x0) const;
+    std::string nl_r(const double* lbg, const double* ubg) const;
+    std::string nl_b(const double* lbx, const double* ubx) const;
+
+    /// Write the .nl file, only the segments that changed since the last call
+    void write_nl(AmplInterfaceMemory* m) const;
+
+    /// Read the solution from a .sol file
+    void read_sol(AmplInterfaceMemory* m, const std::string& solname) const;
   };
 
 } // namespace casadi
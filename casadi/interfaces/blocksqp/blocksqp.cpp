@@ -672,6 +672,7 @@ namespace casadi {
 
       /// Check if converged
       hasConverged = calcOptTol(m);
+      Logger::iteration("blocksqp", m->itCount, m->obj, m->cNormS, m->tol);
       if (print_iteration_) printProgress(m);
       updateStats(m);
       if (hasConverged) {
@@ -820,6 +821,7 @@ namespace casadi {
       hasConverged = calcOptTol(m);
 
       /// Print one line of output for the current iteration
+      Logger::iteration("blocksqp", m->itCount, m->obj, m->cNormS, m->tol);
       if (print_iteration_) printProgress(m);
       updateStats(m);
       if (hasConverged && m->steptype < 2) {
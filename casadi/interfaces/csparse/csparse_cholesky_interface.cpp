@@ -65,6 +65,16 @@ namespace casadi {
     LinsolInternal::init(opts);
   }
 
+  size_t CSparseCholeskyInterface::mem_footprint(void* mem) const {
+    auto m = static_cast<CsparseCholMemory*>(mem);
+    size_t ret = m->temp.capacity()*sizeof(double)
+      + (m->colind.capacity() + m->row.capacity())*sizeof(int);
+    if (m->L && m->L->L) {
+      ret += m->L->L->nzmax*(sizeof(double) + sizeof(int)) + (m->L->L->n+1)*sizeof(int);
+    }
+    return ret;
+  }
+
   int CSparseCholeskyInterface::init_mem(void* mem) const {
     if (LinsolInternal::init_mem(mem)) return 1;
     auto m = static_cast<CsparseCholMemory*>(mem);
@@ -93,6 +93,9 @@ namespace casadi {
     /** \brief Free memory block */
     void free_mem(void *mem) const override { delete static_cast<CsparseCholMemory*>(mem);}
 
+    /** \brief Bytes allocated by a memory block */
+    size_t mem_footprint(void* mem) const override;
+
     // Symbolic factorization
     int sfact(void* mem, const double* A) const override;
 
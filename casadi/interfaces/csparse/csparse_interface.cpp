@@ -63,6 +63,24 @@ namespace casadi {
     LinsolInternal::init(opts);
   }
 
+  // Bytes allocated by a compressed column matrix
+  static size_t cs_footprint(const cs* A) {
+    if (A==nullptr) return 0;
+    return A->nzmax*(sizeof(double) + sizeof(int)) + (A->n+1)*sizeof(int);
+  }
+
+  size_t CsparseInterface::mem_footprint(void* mem) const {
+    auto m = static_cast<CsparseMemory*>(mem);
+    size_t ret = m->temp_.capacity()*sizeof(double)
+      + (m->colind.capacity() + m->row.capacity())*sizeof(int);
+    if (m->N) {
+      ret += cs_footprint(m->N->L) + cs_footprint(m->N->U);
+      if (m->N->pinv) ret += m->A.m*sizeof(int);
+      if (m->N->B) ret += m->A.n*sizeof(double);
+    }
+    return ret;
+  }
+
   int CsparseInterface::init_mem(void* mem) const {
     if (LinsolInternal::init_mem(mem)) return 1;
     auto m = static_cast<CsparseMemory*>(mem);
@@ -146,77 +146,7 @@ namespace casadi {
     const std::vector<casadi_int>& nu = nus_;
 
     if (detect_structure) {
-      /* General strategy: look for the xk+1 diagonal part in A
-      */
-
-      // Find the right-most column for each row in A -> A_skyline
-      // Find the second-to-right-most column -> A_skyline2
-      // Find the left-most column -> A_bottomline
-      Sparsity AT = A_.T();
-      std::vector<casadi_int> A_skyline;
-      std::vector<casadi_int> A_skyline2;
-      std::vector<casadi_int> A_bottomline;
-      for (casadi_int i=0;i<AT.size2();++i) {
-        casadi_int pivot = AT.colind()[i+1];
-        A_bottomline.push_back(AT.row()[AT.colind()[i]]);
-        if (pivot>AT.colind()[i]) {
-          A_skyline.push_back(AT.row()[pivot-1]);
-          if (pivot>AT.colind()[i]+1) {
-            A_skyline2.push_back(AT.row()[pivot-2]);
-          } else {
-            A_skyline2.push_back(-1);
-          }
-        } else {
-          A_skyline.push_back(-1);
-          A_skyline2.push_back(-1);
-        }
-      }
-
-      /*
-      Loop over the right-most columns of A:
-      they form the diagonal part due to xk+1 in gap constraints.
-      detect when the diagonal pattern is broken -> new stage
-      */
-      casadi_int pivot = 0; // Current right-most element
-      casadi_int start_pivot = pivot; // First right-most element that started the stage
-      casadi_int cg = 0; // Counter for non-gap-closing constraints
-      for (casadi_int i=0;i<na_;++i) { // Loop over all rows
-        bool commit = false; // Set true to jump to the stage
-        if (A_skyline[i]>pivot+1) { // Jump to a diagonal in the future
-          nus_.push_back(A_skyline[i]-pivot-1); // Size of jump equals number of states
-          commit = true;
-        } else if (A_skyline[i]==pivot+1) { // Walking the diagonal
-          if (A_skyline2[i]<start_pivot) { // Free of below-diagonal entries?
-            pivot++;
-          } else {
-            nus_.push_back(0); // We cannot but conclude that we arrived at a new stage
-            commit = true;
-          }
-        } else { // non-gap-closing constraint detected
-          cg++;
-        }
-
-        if (commit) {
-          nxs_.push_back(pivot-start_pivot+1);
-          ngs_.push_back(cg); cg=0;
-          start_pivot = A_skyline[i];
-          pivot = A_skyline[i];
-        }
-      }
-      nxs_.push_back(pivot-start_pivot+1);
-
-      // Correction for k==0
-      nxs_[0] = A_skyline[0];
-      nus_[0] = 0;
-      ngs_.erase(ngs_.begin());
-      casadi_int cN=0;
-      for (casadi_int i=na_-1;i>=0;--i) {
-        if (A_bottomline[i]<start_pivot) break;
-        cN++;
-      }
-      ngs_.push_back(cg-cN);
-      ngs_.push_back(cN);
-
+      detect_ocp_structure(A_, nxs_, nus_, ngs_);
       N_ = nus_.size();
       if (verbose_) {
         casadi_message("Detected structure: N " + str(N_) + ", nx " + str(nx) + ", "
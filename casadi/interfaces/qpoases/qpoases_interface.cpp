@@ -85,6 +85,13 @@ namespace casadi {
       {"linsol_plugin",
        {OT_STRING,
         "Linear solver plugin"}},
+      {"fixed_matrices",
+       {OT_BOOL,
+        "H and A are the same in every call: hotstart with the vector data only [false]"}},
+      {"check_matrices",
+       {OT_BOOL,
+        "Compare H and A with the previous call and hotstart with "
+        "the vector data only if unchanged [true]"}},
       {"nWSR",
        {OT_INT,
         "The maximum number of working set recalculations to be performed during "
@@ -201,6 +208,8 @@ namespace casadi {
     max_cputime_ = -1;
     ops_.setToDefault();
     linsol_plugin_ = "ma27";
+    fixed_matrices_ = false;
+    check_matrices_ = true;
 
     // Read options
     for (auto&& op : opts) {
@@ -229,6 +238,10 @@ namespace casadi {
         max_schur_ = op.second;
       } else if (op.first=="linsol_plugin") {
         linsol_plugin_ = string(op.second);
+      } else if (op.first=="fixed_matrices") {
+        fixed_matrices_ = op.second;
+      } else if (op.first=="check_matrices") {
+        check_matrices_ = op.second;
       } else if (op.first=="nWSR") {
         max_nWSR_ = op.second;
       } else if (op.first=="CPUtime") {
@@ -297,13 +310,6 @@ namespace casadi {
     }
 
     // Allocate work vectors
-    if (sparse_) {
-      alloc_w(nnz_in(CONIC_H), true); // h
-      alloc_w(nnz_in(CONIC_A), true); // a
-    } else {
-      alloc_w(nx_*nx_, true); // h
-      alloc_w(nx_*na_, true); // a
-    }
     alloc_w(nx_, true); // g
     alloc_w(nx_, true); // lbx
     alloc_w(nx_, true); // ubx
@@ -312,9 +318,17 @@ namespace casadi {
     alloc_w(nx_+na_, true); // dual
   }
 
+  /// Compare (possibly null) nonzeros with a stored copy
+  static bool nz_equal(const double* x, const std::vector<double>& y) {
+    if (x) return std::equal(y.begin(), y.end(), x);
+    for (double e : y) if (e!=0) return false;
+    return true;
+  }
+
   int QpoasesInterface::init_mem(void* mem) const {
     auto m = static_cast<QpoasesMemory*>(mem);
     m->called_once = false;
+    m->vector_hotstart = false;
 
     // Linear solver, if any
     m->linsol_plugin = linsol_plugin_;
@@ -324,7 +338,8 @@ namespace casadi {
     if (schur_) {
       m->sqp = new qpOASES::SQProblemSchur(nx_, na_, hess_, max_schur_,
         mem, qpoases_init, qpoases_sfact, qpoases_nfact, qpoases_solve);
-    } else if (na_==0) {
+    } else if (na_==0 && !sparse_) {
+      // The sparse matrix interface is only available for SQProblem
       m->qp = new qpOASES::QProblemB(nx_, hess_);
     } else {
       m->sqp = new qpOASES::SQProblem(nx_, na_, hess_);
@@ -340,6 +355,12 @@ namespace casadi {
     m->h_colind.resize(H_.size2()+1);
     m->a_row.resize(A_.nnz());
     m->a_colind.resize(A_.size2()+1);
+    m->h_nz.resize(H_.nnz());
+    m->a_nz.resize(A_.nnz());
+    if (!sparse_) {
+      m->h_dense.resize(nx_*nx_);
+      m->a_dense.resize(nx_*na_);
+    }
 
     return 0;
   }
@@ -381,70 +402,87 @@ namespace casadi {
     // Return flag
     casadi_int flag;
 
+    // Do H and A need to be passed to qpOASES?
+    bool new_matrices = !m->called_once;
+    if (!new_matrices && !fixed_matrices_) {
+      new_matrices = !check_matrices_ || !nz_equal(arg[CONIC_H], m->h_nz)
+        || !nz_equal(arg[CONIC_A], m->a_nz);
+    }
+    if (new_matrices) {
+      casadi_copy(arg[CONIC_H], H_.nnz(), get_ptr(m->h_nz));
+      casadi_copy(arg[CONIC_A], A_.nnz(), get_ptr(m->a_nz));
+    }
+
     // Sparse or dense mode?
     if (sparse_) {
-      // Get quadratic term
-      copy_vector(H_.colind(), m->h_colind);
-      copy_vector(H_.row(), m->h_row);
-      double* h=w; w += H_.nnz();
-      casadi_copy(arg[CONIC_H], H_.nnz(), h);
-      if (m->h) delete m->h;
-      m->h = new qpOASES::SymSparseMat(H_.size1(), H_.size2(),
-        get_ptr(m->h_row), get_ptr(m->h_colind), h);
-      m->h->createDiagInfo();
-
-      // Get linear term
-      copy_vector(A_.colind(), m->a_colind);
-      copy_vector(A_.row(), m->a_row);
-      double* a=w; w += A_.nnz();
-      casadi_copy(arg[CONIC_A], A_.nnz(), a);
-      if (m->a) delete m->a;
-      m->a = new qpOASES::SparseMatrix(A_.size1(), A_.size2(),
-        get_ptr(m->a_row), get_ptr(m->a_colind), a);
+      if (new_matrices) {
+        // Get quadratic term
+        copy_vector(H_.colind(), m->h_colind);
+        copy_vector(H_.row(), m->h_row);
+        if (m->h) delete m->h;
+        m->h = new qpOASES::SymSparseMat(H_.size1(), H_.size2(),
+          get_ptr(m->h_row), get_ptr(m->h_colind), get_ptr(m->h_nz));
+        m->h->createDiagInfo();
+
+        // Get linear term
+        copy_vector(A_.colind(), m->a_colind);
+        copy_vector(A_.row(), m->a_row);
+        if (m->a) delete m->a;
+        m->a = new qpOASES::SparseMatrix(A_.size1(), A_.size2(),
+          get_ptr(m->a_row), get_ptr(m->a_colind), get_ptr(m->a_nz));
+      }
 
       m->fstats.at("preprocessing").toc();
       m->fstats.at("solver").tic();
 
       // Solve sparse
-      if (m->called_once) {
+      if (!m->called_once) {
+        flag = m->sqp->init(m->h, g, m->a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
+      } else if (new_matrices) {
         flag = m->sqp->hotstart(m->h, g, m->a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
       } else {
-        flag = m->sqp->init(m->h, g, m->a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
+        flag = m->sqp->hotstart(g, lb, ub, lbA, ubA, nWSR, cputime_ptr);
       }
       m->fstats.at("solver").toc();
 
     } else {
-      // Get quadratic term
-      double* h=w; w += nx_*nx_;
-      casadi_densify(arg[CONIC_H], H_, h, false);
-
-      // Get linear term
-      double* a = w; w += nx_*na_;
-      casadi_densify(arg[CONIC_A], A_, a, true);
+      double* h = get_ptr(m->h_dense);
+      double* a = get_ptr(m->a_dense);
+      if (new_matrices) {
+        // Get quadratic term
+        casadi_densify(get_ptr(m->h_nz), H_, h, false);
+
+        // Get linear term
+        casadi_densify(get_ptr(m->a_nz), A_, a, true);
+      }
 
       m->fstats.at("preprocessing").toc();
       m->fstats.at("solver").tic();
       // Solve dense
       if (na_==0) {
-        if (m->called_once) {
-          // Broken?
-          //flag = m->qp->hotstart(g, lb, ub, nWSR, cputime_ptr);
+        if (!m->called_once) {
+          flag = m->qp->init(h, g, lb, ub, nWSR, cputime_ptr);
+        } else if (new_matrices) {
+          // QProblemB cannot hotstart with a new Hessian
           m->qp->reset();
           flag = m->qp->init(h, g, lb, ub, nWSR, cputime_ptr);
         } else {
-          flag = m->qp->init(h, g, lb, ub, nWSR, cputime_ptr);
+          flag = m->qp->hotstart(g, lb, ub, nWSR, cputime_ptr);
         }
       } else {
-        if (m->called_once) {
+        if (!m->called_once) {
+          flag = m->sqp->init(h, g, a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
+        } else if (new_matrices) {
           flag = m->sqp->hotstart(h, g, a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
         } else {
-          flag = m->sqp->init(h, g, a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
+          flag = m->sqp->hotstart(g, lb, ub, lbA, ubA, nWSR, cputime_ptr);
         }
       }
       m->fstats.at("solver").toc();
     }
 
     // Solver is "warm" now
+    m->vector_hotstart = m->called_once && !new_matrices;
     m->called_once = true;
 
     m->fstats.at("postprocessing").tic();
@@ -926,6 +964,7 @@ namespace casadi {
     auto m = static_cast<QpoasesMemory*>(mem);
     stats["return_status"] = getErrorMessage(m->return_status);
     stats["success"] = m->success;
+    stats["vector_hotstart"] = m->vector_hotstart;
     return stats;
   }
 
@@ -64,6 +64,15 @@ namespace casadi {
     /// Has qpOASES been called once?
     bool called_once;
 
+    /// Did the last call hotstart with the vector data only?
+    bool vector_hotstart;
+
+    // Nonzeros of H and A passed in the last call
+    std::vector<double> h_nz, a_nz;
+
+    // Dense H and A (qpOASES keeps shallow copies, so they must outlive eval)
+    std::vector<double> h_dense, a_dense;
+
     // Map linear system nonzeros
     std::vector<casadi_int> lin_map;
 
@@ -182,6 +191,8 @@ namespace casadi {
     bool schur_;
     casadi_int max_schur_;
     std::string linsol_plugin_;
+    bool fixed_matrices_;
+    bool check_matrices_;
     ///@}
 
     /// Throw error
@@ -307,4 +307,12 @@ namespace casadi {
     return S_->get_jacobian(name, inames, onames, opts);
   }
 
+  Function BSplineInterpolant::
+  get_value_jacobian(const std::string& name,
+                     const std::vector<std::string>& inames,
+                     const std::vector<std::string>& onames,
+                     const Dict& opts) const {
+    return S_->get_value_jacobian(name, inames, onames, opts);
+  }
+
 } // namespace casadi
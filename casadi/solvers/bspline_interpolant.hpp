@@ -91,6 +91,15 @@ namespace casadi {
                                       const Dict& opts) const override;
     ///@}
 
+    ///@{
+    /** \brief Value and Jacobian, sharing the knot lookup */
+    bool has_value_jacobian() const override { return true;}
+    Function get_value_jacobian(const std::string& name,
+                                const std::vector<std::string>& inames,
+                                const std::vector<std::string>& onames,
+                                const Dict& opts) const override;
+    ///@}
+
     /** \brief Is codegen supported? */
     bool has_codegen() const override { return true;}
 
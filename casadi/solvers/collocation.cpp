@@ -308,7 +308,7 @@ namespace casadi {
     ImplicitFixedStepIntegrator::reset(mem, t, x, z, p);
 
     // Initial guess for Z
-    double* Z = get_ptr(m->Z);
+    double* Z = m->Z;
     for (casadi_int d=0; d<deg_; ++d) {
       casadi_copy(x, nx_, Z);
       Z += nx_;
@@ -325,7 +325,7 @@ namespace casadi {
     ImplicitFixedStepIntegrator::resetB(mem, t, rx, rz, rp);
 
     // Initial guess for RZ
-    double* RZ = get_ptr(m->RZ);
+    double* RZ = m->RZ;
     for (casadi_int d=0; d<deg_; ++d) {
       casadi_copy(rx, nrx_, RZ);
       RZ += nrx_;
@@ -334,4 +334,30 @@ namespace casadi {
     }
   }
 
+  void Collocation::codegen_reset(CodeGenerator& g) const {
+    // Reset the base classes
+    ImplicitFixedStepIntegrator::codegen_reset(g);
+
+    // Initial guess for Z
+    g.local("i", "casadi_int");
+    g << "for (i=0; i<" << deg_ << "; ++i) {\n";
+    g << g.copy("arg[" + str(INTEGRATOR_X0) + "]", nx_, "Z+i*" + str(nx_+nz_)) << "\n";
+    g << g.copy("arg[" + str(INTEGRATOR_Z0) + "]", nz_, "Z+i*" + str(nx_+nz_) + "+" + str(nx_))
+      << "\n";
+    g << "}\n";
+  }
+
+  void Collocation::codegen_resetB(CodeGenerator& g) const {
+    // Reset the base classes
+    ImplicitFixedStepIntegrator::codegen_resetB(g);
+
+    // Initial guess for RZ
+    g.local("i", "casadi_int");
+    g << "for (i=0; i<" << deg_ << "; ++i) {\n";
+    g << g.copy("arg[" + str(INTEGRATOR_RX0) + "]", nrx_, "RZ+i*" + str(nrx_+nrz_)) << "\n";
+    g << g.copy("arg[" + str(INTEGRATOR_RZ0) + "]", nrz_,
+                "RZ+i*" + str(nrx_+nrz_) + "+" + str(nrx_)) << "\n";
+    g << "}\n";
+  }
+
 } // namespace casadi
@@ -97,6 +97,12 @@ namespace casadi {
     void resetB(IntegratorMemory* mem, double t, const double* rx,
                         const double* rz, const double* rp) const override;
 
+    /** \brief Generate code for resetting the forward problem */
+    void codegen_reset(CodeGenerator& g) const override;
+
+    /** \brief Generate code for resetting the backward problem */
+    void codegen_resetB(CodeGenerator& g) const override;
+
     // Interpolation order
     casadi_int deg_;
 
@@ -0,0 +1,461 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "condensing.hpp"
+#include <numeric>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_CONIC_CONDENSING_EXPORT
+  casadi_register_conic_condensing(Conic::Plugin* plugin) {
+    plugin->creator = Condensing::creator;
+    plugin->name = "condensing";
+    plugin->doc = Condensing::meta_doc.c_str();
+    plugin->version = CASADI_VERSION;
+    plugin->options = &Condensing::options_;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_CONIC_CONDENSING_EXPORT casadi_load_conic_condensing() {
+    Conic::registerPlugin(casadi_register_conic_condensing);
+  }
+
+  Condensing::Condensing(const std::string& name, const std::map<std::string, Sparsity> &st)
+    : Conic(name, st) {
+  }
+
+  Condensing::~Condensing() {
+    clear_mem();
+  }
+
+  Options Condensing::options_
+  = {{&Conic::options_},
+     {{"N",
+       {OT_INT,
+        "OCP horizon"}},
+      {"nx",
+       {OT_INTVECTOR,
+        "Number of states, length N+1"}},
+      {"nu",
+       {OT_INTVECTOR,
+        "Number of controls, length N"}},
+      {"ng",
+       {OT_INTVECTOR,
+        "Number of non-dynamic constraints, length N+1"}},
+      {"qpsol",
+       {OT_STRING,
+        "Conic plugin for the condensed QP [qrqp]"}},
+      {"qpsol_options",
+       {OT_DICT,
+        "Options to be passed to the condensed QP solver"}}
+     }
+  };
+
+  void Condensing::init(const Dict& opts) {
+    // Initialize the base classes
+    Conic::init(opts);
+
+    // Default options
+    string qpsol_plugin = "qrqp";
+    Dict qpsol_options;
+    casadi_int struct_cnt=0;
+
+    // Read user options
+    for (auto&& op : opts) {
+      if (op.first=="N") {
+        N_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="nx") {
+        nxs_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="nu") {
+        nus_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="ng") {
+        ngs_ = op.second;
+        struct_cnt++;
+      } else if (op.first=="qpsol") {
+        qpsol_plugin = op.second.to_string();
+      } else if (op.first=="qpsol_options") {
+        qpsol_options = op.second;
+      }
+    }
+
+    casadi_assert(struct_cnt==0 || struct_cnt==4,
+      "You must either set all of N, nx, nu, ng; "
+      "or set none at all (automatic detection).");
+
+    const std::vector<casadi_int>& nx = nxs_;
+    const std::vector<casadi_int>& ng = ngs_;
+    const std::vector<casadi_int>& nu = nus_;
+
+    if (struct_cnt==0) {
+      detect_ocp_structure(A_, nxs_, nus_, ngs_);
+      N_ = nus_.size();
+      if (verbose_) {
+        casadi_message("Detected structure: N " + str(N_) + ", nx " + str(nx) + ", "
+          "nu " + str(nu) + ", ng " + str(ng) + ".");
+      }
+    }
+
+    casadi_assert(nx.size()==N_+1 && nu.size()==N_ && ng.size()==N_+1,
+      "Inconsistent structure: N " + str(N_) + ", nx " + str(nx) + ", "
+      "nu " + str(nu) + ", ng " + str(ng) + ".");
+    casadi_assert(nx_ == std::accumulate(nx.begin(), nx.end(), 0) +
+      std::accumulate(nu.begin(), nu.end(), 0),
+      "sum(nx)+sum(nu) = must equal total size of variables (" + str(nx_) + "). "
+      "Structure is: N " + str(N_) + ", nx " + str(nx) + ", "
+      "nu " + str(nu) + ", ng " + str(ng) + ".");
+    casadi_assert(na_ == std::accumulate(nx.begin()+1, nx.end(), 0) +
+      std::accumulate(ng.begin(), ng.end(), 0),
+      "sum(nx+1)+sum(ng) = must equal total size of constraints (" + str(na_) + "). "
+      "Structure is: N " + str(N_) + ", nx " + str(nx) + ", "
+      "nu " + str(nu) + ", ng " + str(ng) + ".");
+
+    // Offsets of the states and controls, first gap constraint row of each stage
+    std::vector<casadi_int> ox(N_+1), ou(N_), og(N_);
+    // Rows of the non-dynamic constraints, states that are not eliminated/eliminated
+    std::vector<casadi_int> g_rows, z_rows, x_rows;
+    // Stage of each gap constraint (-1 for other constraints)
+    std::vector<casadi_int> gap_stage(na_, -1);
+    casadi_int offset_c = 0, offset_r = 0;
+    for (casadi_int k=0; k<=N_; ++k) {
+      ox[k] = offset_c;
+      for (casadi_int i=0; i<nx[k]; ++i) (k==0 ? z_rows : x_rows).push_back(offset_c++);
+      if (k==N_) break;
+      ou[k] = offset_c;
+      for (casadi_int i=0; i<nu[k]; ++i) z_rows.push_back(offset_c++);
+      og[k] = offset_r;
+      for (casadi_int i=0; i<nx[k+1]; ++i) {
+        gap_.push_back(offset_r);
+        gap_stage[offset_r++] = k;
+      }
+      for (casadi_int i=0; i<ng[k]; ++i) g_rows.push_back(offset_r++);
+    }
+    for (casadi_int i=0; i<ng[N_]; ++i) g_rows.push_back(offset_r++);
+    nz_ = z_rows.size();
+    nac_ = g_rows.size() + x_rows.size();
+
+    // Gap constraints may only depend on x_k, u_k and (diagonally) on x_{k+1}
+    std::vector<casadi_int> n_diag(na_, 0);
+    const casadi_int* A_colind = A_.colind();
+    const casadi_int* A_row = A_.row();
+    for (casadi_int c=0; c<nx_; ++c) {
+      for (casadi_int el=A_colind[c]; el<A_colind[c+1]; ++el) {
+        casadi_int r = A_row[el], k = gap_stage[r];
+        if (k<0) continue;
+        if (c==ox[k+1]+r-og[k]) {
+          n_diag[r]++;
+        } else {
+          casadi_assert(c>=ox[k] && c<ox[k+1],
+            "Condensing: gap constraint " + str(r) + " of stage " + str(k) + " depends on "
+            "variable " + str(c) + ", which is not part of stage " + str(k) + ". "
+            "Structure is: N " + str(N_) + ", nx " + str(nx) + ", nu " + str(nu) + ", "
+            "ng " + str(ng) + ".");
+        }
+      }
+    }
+    for (casadi_int r : gap_) {
+      casadi_assert(n_diag[r]==1,
+        "Condensing: gap constraint " + str(r) + " must depend on the next state. "
+        "Structure is: N " + str(N_) + ", nx " + str(nx) + ", nu " + str(nu) + ", "
+        "ng " + str(ng) + ".");
+    }
+
+    // Symbolic QP data
+    SX h = SX::sym("h", H_), g = SX::sym("g", nx_), a = SX::sym("a", A_);
+    SX lba = SX::sym("lba", na_), uba = SX::sym("uba", na_);
+    SX lbx = SX::sym("lbx", nx_), ubx = SX::sym("ubx", nx_);
+    SX x0 = SX::sym("x0", nx_), lam_x0 = SX::sym("lam_x0", nx_), lam_a0 = SX::sym("lam_a0", na_);
+
+    // Dynamics blocks: x_{k+1} = inv(I_k)*(b_k - A_k*x_k - B_k*u_k)
+    std::vector<SX> Ak(N_), Bk(N_), Ik_inv(N_);
+    for (casadi_int k=0; k<N_; ++k) {
+      Slice rk(og[k], og[k]+nx[k+1]);
+      Ak[k] = a(rk, Slice(ox[k], ox[k]+nx[k]));
+      Bk[k] = a(rk, Slice(ou[k], ou[k]+nu[k]));
+      Ik_inv[k] = diag(1/diag(a(rk, Slice(ox[k+1], ox[k+1]+nx[k+1]))));
+    }
+
+    // Forward recursion for the condensing matrix T and offset t: w = T*z + t,
+    // with condensed variables z = [x0; u0; ...; u_{N-1}]
+    std::vector<SX> T_blocks, t_blocks;
+    SX M = horzcat(SX::eye(nx[0]), SX(nx[0], nz_-nx[0]));
+    SX c = SX::zeros(nx[0], 1);
+    casadi_int offset_z = nx[0];
+    for (casadi_int k=0; k<N_; ++k) {
+      SX E = horzcat(SX(nu[k], offset_z), SX::eye(nu[k]), SX(nu[k], nz_-offset_z-nu[k]));
+      offset_z += nu[k];
+      T_blocks.push_back(M);
+      T_blocks.push_back(E);
+      t_blocks.push_back(c);
+      t_blocks.push_back(SX::zeros(nu[k], 1));
+      M = -mtimes(Ik_inv[k], mtimes(Ak[k], M) + mtimes(Bk[k], E));
+      c = mtimes(Ik_inv[k], lba(Slice(og[k], og[k]+nx[k+1])) - mtimes(Ak[k], c));
+    }
+    T_blocks.push_back(M);
+    t_blocks.push_back(c);
+    SX T = vertcat(T_blocks), t = vertcat(t_blocks);
+
+    // Condensed constraints: non-dynamic constraints and state bounds
+    SX a_g = a(g_rows, Slice());
+    SX Ac = vertcat(mtimes(a_g, T), T(x_rows, Slice()));
+
+    // Condensing matrix and condensed constraint matrix only depend on A
+    dyn_fcn_ = Function(name_ + "_dyn", {a}, {T, Ac});
+    alloc(dyn_fcn_);
+
+    // Condensed Hessian
+    SX T_sym = SX::sym("T", T.sparsity());
+    SX Hc = mtimes(T_sym.T(), mtimes(h, T_sym));
+    hess_fcn_ = Function(name_ + "_hess", {h, T_sym}, {Hc});
+    alloc(hess_fcn_);
+
+    // Condensed vector data. Vectors with a single entry are scalars, whose entries
+    // would be indexed as a row: vec keeps all selections columns
+    SX ht = mtimes(h, t);
+    SX gc = mtimes(T_sym.T(), ht + g);
+    SX f0 = 0.5*dot(t, ht) + dot(g, t);
+    SX a_g_t = mtimes(a_g, t);
+    SX lbac = vertcat(vec(lba(g_rows)) - a_g_t, vec(lbx(x_rows)) - vec(t(x_rows)));
+    SX ubac = vertcat(vec(uba(g_rows)) - a_g_t, vec(ubx(x_rows)) - vec(t(x_rows)));
+    vec_fcn_ = Function(name_ + "_vec",
+      {h, g, a, lba, uba, lbx, ubx, x0, lam_x0, lam_a0, T_sym},
+      {t, gc, lbac, ubac, vec(lbx(z_rows)), vec(ubx(z_rows)), vec(x0(z_rows)),
+       vec(lam_x0(z_rows)), vertcat(vec(lam_a0(g_rows)), vec(lam_x0(x_rows))), f0});
+    alloc(vec_fcn_);
+
+    // Expansion of the solution
+    SX t_sym = SX::sym("t", nx_);
+    SX z = SX::sym("z", nz_), lam_z = SX::sym("lam_z", nz_), lam_ac = SX::sym("lam_ac", nac_);
+    SX x = mtimes(T_sym, z) + t_sym;
+    SX lam_x = SX::zeros(nx_, 1), lam_a = SX::zeros(na_, 1);
+    // Empty selections of scalars are rows, skip them
+    casadi_int n_g = g_rows.size();
+    if (!z_rows.empty()) lam_x(z_rows) = lam_z;
+    if (!x_rows.empty()) lam_x(x_rows) = lam_ac(Slice(n_g, nac_));
+    if (!g_rows.empty()) lam_a(g_rows) = lam_ac(Slice(0, n_g));
+
+    // Backward recursion for the multipliers of the gap constraints,
+    // from stationarity of the Lagrangian w.r.t. x_1 ... x_N
+    SX r = mtimes(h, x) + g + mtimes(a.T(), lam_a) + lam_x;
+    SX lam_gap;
+    for (casadi_int k=N_; k>0; --k) {
+      SX rk = r(Slice(ox[k], ox[k]+nx[k]));
+      if (k<N_) rk += mtimes(Ak[k].T(), lam_gap);
+      lam_gap = -mtimes(Ik_inv[k-1], rk);
+      lam_a(Slice(og[k-1], og[k-1]+nx[k])) = lam_gap;
+    }
+    exp_fcn_ = Function(name_ + "_exp", {h, g, a, T_sym, t_sym, z, lam_z, lam_ac}, {x, lam_x, lam_a});
+    alloc(exp_fcn_);
+
+    // Allocate the dense QP solver
+    qpsol_ = conic(name_ + "_qpsol", qpsol_plugin, {{"h", Hc.sparsity()}, {"a", Ac.sparsity()}},
+                   qpsol_options);
+    alloc(qpsol_);
+
+    // Work vectors
+    alloc_w(nx_, true); // t
+    alloc_w(nz_, true); // gc
+    alloc_w(nac_, true); // lbac
+    alloc_w(nac_, true); // ubac
+    alloc_w(nz_, true); // lbz
+    alloc_w(nz_, true); // ubz
+    alloc_w(nz_, true); // z0
+    alloc_w(nz_, true); // lam_z0
+    alloc_w(nac_, true); // lam_ac0
+    alloc_w(1, true); // f0
+    alloc_w(nz_, true); // z
+    alloc_w(nz_, true); // lam_z
+    alloc_w(nac_, true); // lam_ac
+    alloc_w(1, true); // cost
+  }
+
+  int Condensing::init_mem(void* mem) const {
+    auto m = static_cast<CondensingMemory*>(mem);
+    m->called_once = false;
+    m->a.resize(A_.nnz());
+    m->h.resize(H_.nnz());
+    m->T.resize(dyn_fcn_.nnz_out(0));
+    m->Ac.resize(dyn_fcn_.nnz_out(1));
+    m->Hc.resize(hess_fcn_.nnz_out(0));
+    m->fstats["preprocessing"]  = FStats();
+    m->fstats["solver"]         = FStats();
+    m->fstats["postprocessing"] = FStats();
+    return 0;
+  }
+
+  /// Compare (possibly null) nonzeros with a stored copy
+  static bool nz_equal(const double* x, const std::vector<double>& y) {
+    if (x) return std::equal(y.begin(), y.end(), x);
+    for (double e : y) if (e!=0) return false;
+    return true;
+  }
+
+  int Condensing::
+  eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    auto m = static_cast<CondensingMemory*>(mem);
+
+    // Statistics
+    for (auto&& s : m->fstats) s.second.reset();
+    m->fstats.at("preprocessing").tic();
+
+    if (inputs_check_) {
+      check_inputs(arg[CONIC_LBX], arg[CONIC_UBX], arg[CONIC_LBA], arg[CONIC_UBA]);
+    }
+
+    // Gap constraints are eliminated, so they must be equalities
+    for (casadi_int i : gap_) {
+      double lb = arg[CONIC_LBA] ? arg[CONIC_LBA][i] : 0;
+      double ub = arg[CONIC_UBA] ? arg[CONIC_UBA][i] : 0;
+      casadi_assert(lb==ub, "Condensing: gap constraint " + str(i) + " must be an equality. "
+        "Got LBA[" + str(i) + "]=" + str(lb) + " and UBA[" + str(i) + "]=" + str(ub) + ".");
+    }
+
+    // Work vectors
+    double *t = w; w += nx_;
+    double *gc = w; w += nz_;
+    double *lbac = w; w += nac_;
+    double *ubac = w; w += nac_;
+    double *lbz = w; w += nz_;
+    double *ubz = w; w += nz_;
+    double *z0 = w; w += nz_;
+    double *lam_z0 = w; w += nz_;
+    double *lam_ac0 = w; w += nac_;
+    double *f0 = w; w += 1;
+    double *z = w; w += nz_;
+    double *lam_z = w; w += nz_;
+    double *lam_ac = w; w += nac_;
+    double *cost = w; w += 1;
+
+    // Buffers for calling the auxiliary functions
+    const double** arg1 = arg + n_in_;
+    double** res1 = res + n_out_;
+
+    // Condensing matrices are reused as long as the dynamics do not change
+    bool new_a = !m->called_once || !nz_equal(arg[CONIC_A], m->a);
+    bool new_h = !m->called_once || !nz_equal(arg[CONIC_H], m->h);
+    if (new_a) {
+      casadi_copy(arg[CONIC_A], A_.nnz(), get_ptr(m->a));
+      arg1[0] = get_ptr(m->a);
+      res1[0] = get_ptr(m->T);
+      res1[1] = get_ptr(m->Ac);
+      if (dyn_fcn_(arg1, res1, iw, w, 0)) return 1;
+    }
+    if (new_a || new_h) {
+      casadi_copy(arg[CONIC_H], H_.nnz(), get_ptr(m->h));
+      arg1[0] = get_ptr(m->h);
+      arg1[1] = get_ptr(m->T);
+      res1[0] = get_ptr(m->Hc);
+      if (hess_fcn_(arg1, res1, iw, w, 0)) return 1;
+    }
+    m->called_once = true;
+
+    // Condensed vector data
+    arg1[0] = get_ptr(m->h);
+    arg1[1] = arg[CONIC_G];
+    arg1[2] = get_ptr(m->a);
+    arg1[3] = arg[CONIC_LBA];
+    arg1[4] = arg[CONIC_UBA];
+    arg1[5] = arg[CONIC_LBX];
+    arg1[6] = arg[CONIC_UBX];
+    arg1[7] = arg[CONIC_X0];
+    arg1[8] = arg[CONIC_LAM_X0];
+    arg1[9] = arg[CONIC_LAM_A0];
+    arg1[10] = get_ptr(m->T);
+    res1[0] = t;
+    res1[1] = gc;
+    res1[2] = lbac;
+    res1[3] = ubac;
+    res1[4] = lbz;
+    res1[5] = ubz;
+    res1[6] = z0;
+    res1[7] = lam_z0;
+    res1[8] = lam_ac0;
+    res1[9] = f0;
+    if (vec_fcn_(arg1, res1, iw, w, 0)) return 1;
+
+    m->fstats.at("preprocessing").toc();
+    m->fstats.at("solver").tic();
+
+    // Solve the condensed QP
+    fill_n(arg1, static_cast<casadi_int>(CONIC_NUM_IN), nullptr);
+    fill_n(res1, static_cast<casadi_int>(CONIC_NUM_OUT), nullptr);
+    arg1[CONIC_H] = get_ptr(m->Hc);
+    arg1[CONIC_G] = gc;
+    arg1[CONIC_A] = get_ptr(m->Ac);
+    arg1[CONIC_LBA] = lbac;
+    arg1[CONIC_UBA] = ubac;
+    arg1[CONIC_LBX] = lbz;
+    arg1[CONIC_UBX] = ubz;
+    arg1[CONIC_X0] = z0;
+    arg1[CONIC_LAM_X0] = lam_z0;
+    arg1[CONIC_LAM_A0] = lam_ac0;
+    res1[CONIC_X] = z;
+    res1[CONIC_COST] = cost;
+    res1[CONIC_LAM_A] = lam_ac;
+    res1[CONIC_LAM_X] = lam_z;
+    int flag = qpsol_(arg1, res1, iw, w, 0);
+
+    m->fstats.at("solver").toc();
+    m->fstats.at("postprocessing").tic();
+
+    // Recover the solution of the original QP
+    arg1[0] = get_ptr(m->h);
+    arg1[1] = arg[CONIC_G];
+    arg1[2] = get_ptr(m->a);
+    arg1[3] = get_ptr(m->T);
+    arg1[4] = t;
+    arg1[5] = z;
+    arg1[6] = lam_z;
+    arg1[7] = lam_ac;
+    res1[0] = res[CONIC_X];
+    res1[1] = res[CONIC_LAM_X];
+    res1[2] = res[CONIC_LAM_A];
+    if (exp_fcn_(arg1, res1, iw, w, 0)) return 1;
+    if (res[CONIC_COST]) *res[CONIC_COST] = *cost + *f0;
+
+    m->fstats.at("postprocessing").toc();
+
+    // Show statistics
+    if (print_time_)  print_fstats(static_cast<ConicMemory*>(mem));
+    return flag;
+  }
+
+  Dict Condensing::get_stats(void* mem) const {
+    Dict stats = Conic::get_stats(mem);
+    Dict qpsol_stats = qpsol_.stats();
+    stats["qpsol_stats"] = qpsol_stats;
+    if (qpsol_stats.find("success")!=qpsol_stats.end()) {
+      stats["success"] = qpsol_stats["success"];
+    }
+    return stats;
+  }
+
+} // namespace casadi
@@ -0,0 +1,142 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_CONDENSING_HPP
+#define CASADI_CONDENSING_HPP
+
+#include "casadi/core/conic_impl.hpp"
+#include <casadi/solvers/casadi_conic_condensing_export.h>
+
+/** \defgroup plugin_Conic_condensing
+   Solve QPs arising from optimal control problems by eliminating the states
+   (condensing) and passing the resulting small, dense QP to another Conic.
+
+   The variables must be ordered stage-wise as [x0 u0 x1 u1 ... xN] and the
+   constraints as [gap0 g0 gap1 g1 ... gN], where the gap (dynamics) constraints
+   A_k x_k + B_k u_k + I_k x_{k+1} == b_k have diagonal I_k.
+   The stage structure is detected automatically unless N, nx, nu, ng are given.
+*/
+
+/** \pluginsection{Conic,condensing} */
+
+/// \cond INTERNAL
+namespace casadi {
+  struct CASADI_CONIC_CONDENSING_EXPORT CondensingMemory : public ConicMemory {
+    // Nonzeros of A and H in the last call
+    std::vector<double> a, h;
+
+    // Condensing matrix, condensed A and condensed H
+    std::vector<double> T, Ac, Hc;
+
+    // Has the memory been used?
+    bool called_once;
+  };
+
+  /** \brief \pluginbrief{Conic,condensing}
+
+      @copydoc Conic_doc
+      @copydoc plugin_Conic_condensing
+
+      \date 2026
+  */
+  class CASADI_CONIC_CONDENSING_EXPORT Condensing : public Conic {
+  public:
+    /** \brief  Create a new Solver */
+    explicit Condensing(const std::string& name,
+                        const std::map<std::string, Sparsity> &st);
+
+    /** \brief  Create a new QP Solver */
+    static Conic* creator(const std::string& name,
+                          const std::map<std::string, Sparsity>& st) {
+      return new Condensing(name, st);
+    }
+
+    /** \brief  Destructor */
+    ~Condensing() override;
+
+    // Get name of the plugin
+    const char* plugin_name() const override { return "condensing";}
+
+    // Get name of the class
+    std::string class_name() const override { return "Condensing";}
+
+    /** \brief Create memory block */
+    void* alloc_mem() const override { return new CondensingMemory();}
+
+    /** \brief Initalize memory block */
+    int init_mem(void* mem) const override;
+
+    /** \brief Free memory block */
+    void free_mem(void *mem) const override { delete static_cast<CondensingMemory*>(mem);}
+
+    ///@{
+    /** \brief Options */
+    static Options options_;
+    const Options& get_options() const override { return options_;}
+    ///@}
+
+    /** \brief Initialize */
+    void init(const Dict& opts) override;
+
+    /** \brief Solve the QP */
+    int eval(const double** arg, double** res,
+             casadi_int* iw, double* w, void* mem) const override;
+
+    /// Get all statistics
+    Dict get_stats(void* mem) const override;
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Dense QP solver
+    Function qpsol_;
+
+    /// Condensing matrix and condensed constraints: (a) -> (T, Ac)
+    Function dyn_fcn_;
+
+    /// Condensed Hessian: (h, T) -> (Hc)
+    Function hess_fcn_;
+
+    /// Condensed vector data
+    Function vec_fcn_;
+
+    /// Recover the solution of the original QP
+    Function exp_fcn_;
+
+    /// Stage structure
+    casadi_int N_;
+    std::vector<casadi_int> nxs_, nus_, ngs_;
+
+    /// Gap constraint rows
+    std::vector<casadi_int> gap_;
+
+    /// Number of condensed variables and constraints
+    casadi_int nz_, nac_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_CONDENSING_HPP
@@ -104,6 +104,17 @@ namespace casadi {
     return ret;
   }
 
+  Function LinearInterpolant::
+  get_value_jacobian(const std::string& name,
+                     const std::vector<std::string>& inames,
+                     const std::vector<std::string>& onames,
+                     const Dict& opts) const {
+    Function ret;
+    ret.own(new LinearInterpolantValJac(name));
+    ret->construct(opts);
+    return ret;
+  }
+
   Function LinearInterpolantJac::
   get_jacobian(const std::string& name,
                   const std::vector<std::string>& inames,
@@ -146,4 +157,42 @@ namespace casadi {
       "arg[0]", g.constant(m->lookup_mode_), m->m_, "iw", "w") << "\n";
   }
 
+  void LinearInterpolantValJac::init(const Dict& opts) {
+    // Call the base class initializer
+    FunctionInternal::init(opts);
+
+    // Needed by casadi_interpn_val_grad
+    auto m = derivative_of_.get<LinearInterpolant>();
+    alloc_w(2*m->ndim_ + m->m_, true);
+    alloc_iw(2*m->ndim_, true);
+  }
+
+  int LinearInterpolantValJac::
+  eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const {
+    auto m = derivative_of_.get<LinearInterpolant>();
+    casadi_interpn_val_grad(res[0], res[1], m->ndim_, get_ptr(m->grid_), get_ptr(m->offset_),
+                            get_ptr(m->values_), arg[0], get_ptr(m->lookup_mode_), m->m_, iw, w);
+    return 0;
+  }
+
+  void LinearInterpolantValJac::codegen_body(CodeGenerator& g) const {
+    auto m = derivative_of_.get<LinearInterpolant>();
+    g << "  " << g.interpn_val_grad("res[0]", "res[1]", m->ndim_,
+      g.constant(m->grid_), g.constant(m->offset_), g.constant(m->values_),
+      "arg[0]", g.constant(m->lookup_mode_), m->m_, "iw", "w") << "\n";
+  }
+
+  Function LinearInterpolantValJac::
+  get_jacobian(const std::string& name,
+                  const std::vector<std::string>& inames,
+                  const std::vector<std::string>& onames,
+                  const Dict& opts) const {
+    // Jacobian of the value is available as nondifferentiated output,
+    // second order derivatives are zero as for LinearInterpolantJac
+    MX x = MX::sym(inames.at(0), sparsity_in(0));
+    MX v = MX::sym(inames.at(1), Sparsity(size_out(0)));
+    MX J = MX::sym(inames.at(2), sparsity_out(1));
+    return Function(name, {x, v, J}, {vertcat(J, MX(nnz_out(1), nnz_in(0)))}, opts);
+  }
+
 } // namespace casadi
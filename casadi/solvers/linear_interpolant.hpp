@@ -88,6 +88,15 @@ namespace casadi {
                                       const Dict& opts) const override;
     ///@}
 
+    ///@{
+    /** \brief Value and Jacobian, sharing the grid lookup */
+    bool has_value_jacobian() const override { return true;}
+    Function get_value_jacobian(const std::string& name,
+                                const std::vector<std::string>& inames,
+                                const std::vector<std::string>& onames,
+                                const Dict& opts) const override;
+    ///@}
+
     /** \brief Is codegen supported? */
     bool has_codegen() const override { return true;}
 
@@ -141,6 +150,41 @@ namespace casadi {
 
   };
 
+  /** Value and first order derivatives */
+  class CASADI_INTERPOLANT_LINEAR_EXPORT LinearInterpolantValJac : public FunctionInternal {
+  public:
+    /// Constructor
+    LinearInterpolantValJac(const std::string& name) : FunctionInternal(name) {}
+
+    /// Destructor
+    ~LinearInterpolantValJac() override {}
+
+    /** \brief Get type name */
+    std::string class_name() const override { return "LinearInterpolantValJac";}
+
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override { return true;}
+
+    /** \brief Generate code for the body of the C function */
+    void codegen_body(CodeGenerator& g) const override;
+
+    // Initialize
+    void init(const Dict& opts) override;
+
+    /// Evaluate numerically
+    int eval(const double** arg, double** res, casadi_int* iw, double* w, void* mem) const override;
+
+    ///@{
+    /** \brief Full Jacobian */
+    bool has_jacobian() const override { return true;}
+    Function get_jacobian(const std::string& name,
+                                      const std::vector<std::string>& inames,
+                                      const std::vector<std::string>& onames,
+                                      const Dict& opts) const override;
+    ///@}
+
+  };
+
 } // namespace casadi
 
 /// \endcond
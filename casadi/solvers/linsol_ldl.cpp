@@ -61,6 +61,11 @@ namespace casadi {
     sp_Lt_ = sp_.ldl(p_);
   }
 
+  size_t LinsolLdl::mem_footprint(void* mem) const {
+    auto m = static_cast<LinsolLdlMemory*>(mem);
+    return (m->l.capacity() + m->d.capacity() + m->w.capacity())*sizeof(double);
+  }
+
   int LinsolLdl::init_mem(void* mem) const {
     if (LinsolInternal::init_mem(mem)) return 1;
     auto m = static_cast<LinsolLdlMemory*>(mem);
@@ -71,6 +71,9 @@ namespace casadi {
     /** \brief Free memory block */
     void free_mem(void *mem) const override { delete static_cast<LinsolLdlMemory*>(mem);}
 
+    /** \brief Bytes allocated by a memory block */
+    size_t mem_footprint(void* mem) const override;
+
     // Symbolic factorization
     int sfact(void* mem, const double* A) const override;
 
@@ -80,6 +83,9 @@ namespace casadi {
     // Solve the linear system
     int solve(void* mem, const double* A, double* x, casadi_int nrhs, bool tr) const override;
 
+    /// Is code generation supported?
+    bool has_codegen() const override { return true;}
+
     /// Generate C code
     void generate(CodeGenerator& g, const std::string& A, const std::string& x,
                   casadi_int nrhs, bool tr) const override;
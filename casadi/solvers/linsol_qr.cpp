@@ -61,6 +61,12 @@ namespace casadi {
     sp_.qr_sparse(sp_v_, sp_r_, prinv_, pc_);
   }
 
+  size_t LinsolQr::mem_footprint(void* mem) const {
+    auto m = static_cast<LinsolQrMemory*>(mem);
+    return (m->v.capacity() + m->r.capacity() + m->beta.capacity()
+      + m->w.capacity())*sizeof(double);
+  }
+
   int LinsolQr::init_mem(void* mem) const {
     if (LinsolInternal::init_mem(mem)) return 1;
     auto m = static_cast<LinsolQrMemory*>(mem);
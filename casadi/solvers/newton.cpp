@@ -24,6 +24,7 @@
 
 
 #include "newton.hpp"
+#include "casadi/core/linsol_internal.hpp"
 #include <iomanip>
 
 using namespace std;
@@ -199,6 +200,69 @@ namespace casadi {
     return 0;
   }
 
+  bool Newton::has_codegen() const {
+    // The linear system is solved with the code of the linear solver
+    return linsol_->has_codegen() && get_function("jac_f_z")->has_codegen();
+  }
+
+  void Newton::codegen_declarations(CodeGenerator& g) const {
+    g.add_dependency(get_function("jac_f_z"));
+  }
+
+  void Newton::codegen_body(CodeGenerator& g) const {
+    // Work vectors, same order as in set_work
+    for (const char* v : {"x", "f", "jac"}) g.local(v, "casadi_real", "*");
+    g << "x = w; w += " << n_ << ";\n";
+    g << "f = w; w += " << n_ << ";\n";
+    g << "jac = w; w += " << sp_jac_.nnz() << ";\n";
+    g.local("iter", "casadi_int");
+    g.local("i", "casadi_int");
+
+    // Arguments and results of the called functions
+    std::string arg1 = "arg+" + str(n_in_), res1 = "res+" + str(n_out_);
+    std::string a = "arg[" + str(n_in_), r = "res[" + str(n_out_);
+
+    g.comment("Get the initial guess");
+    g << g.copy("arg[" + str(iin_) + "]", n_, "x") << "\n";
+
+    g.comment("Perform the Newton iterations");
+    g << "iter = 0;\n";
+    g << "while (1) {\n";
+    g.comment("Break if maximum number of iterations already reached");
+    g << "if (iter >= " << max_iter_ << ") " << (error_on_fail_ ? "return 1" : "break") << ";\n";
+    g << "iter++;\n";
+
+    g.comment("Use x to evaluate J");
+    g << "for (i=0; i<" << n_in_ << "; ++i) " << a << "+i] = arg[i];\n";
+    g << a << "+" << iin_ << "] = x;\n";
+    g << r << "] = jac;\n";
+    g << "for (i=0; i<" << n_out_ << "; ++i) " << r << "+1+i] = res[i];\n";
+    g << r << "+" << 1+iout_ << "] = f;\n";
+    g << "if (" << g(get_function("jac_f_z"), arg1, res1, "iw", "w", "0") << ") return 1;\n";
+
+    // Check convergence
+    if (abstol_ != numeric_limits<double>::infinity()) {
+      g.add_auxiliary(CodeGenerator::AUX_NORM_INF);
+      g << "if (casadi_norm_inf(" << n_ << ", f) <= " << g.constant(abstol_) << ") break;\n";
+    }
+
+    g.comment("Factorize the linear solver with J and solve");
+    linsol_->generate(g, "jac", "f", 1, false);
+
+    // Check convergence again
+    if (abstolStep_ != numeric_limits<double>::infinity()) {
+      g.add_auxiliary(CodeGenerator::AUX_NORM_INF);
+      g << "if (casadi_norm_inf(" << n_ << ", f) <= " << g.constant(abstolStep_) << ") break;\n";
+    }
+
+    g.comment("Update Xk+1 = Xk - J^(-1) F");
+    g << g.axpy(n_, "-1.", "f", "x") << "\n";
+    g << "}\n";
+
+    g.comment("Get the solution");
+    g << g.copy("x", n_, "res[" + str(iout_) + "]") << "\n";
+  }
+
   void Newton::printIteration(std::ostream &stream) const {
     stream << setw(5) << "iter";
     stream << setw(10) << "res";
@@ -229,7 +293,8 @@ namespace casadi {
   Dict Newton::get_stats(void* mem) const {
     Dict stats = Rootfinder::get_stats(mem);
     auto m = static_cast<NewtonMemory*>(mem);
-    stats["return_status"] = m->return_status;
+    // Not set if the solver was evaluated in generated code
+    if (m->return_status) stats["return_status"] = m->return_status;
     stats["iter_count"] = m->iter;
     return stats;
   }
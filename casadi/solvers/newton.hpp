@@ -105,6 +105,15 @@ namespace casadi {
     /// Solve the system of equations and calculate derivatives
     int solve(void* mem) const override;
 
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override;
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the function body */
+    void codegen_body(CodeGenerator& g) const override;
+
     /// A documentation string
     static const std::string meta_doc;
 
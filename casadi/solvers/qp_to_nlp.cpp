@@ -185,7 +185,7 @@ namespace casadi {
   }
 
   Dict QpToNlp::get_stats(void* mem) const {
-    Dict stats;
+    Dict stats = Conic::get_stats(mem);
     Dict solver_stats = solver_.stats();
     stats["solver_stats"] = solver_stats;
     stats["success"] = solver_stats["success"];
@@ -199,6 +199,7 @@ namespace casadi {
         flag = 1;
       }
       // Print iteration progress:
+      Logger::iteration("qrqp", iter, d.f, d.pr, d.du);
       if (print_iter_) {
         if (iter % 10 == 0) {
           print("%5s %5s %9s %9s %5s %9s %5s %9s %5s %9s %40s\n",
@@ -235,6 +236,77 @@ namespace casadi {
     return 0;
   }
 
+  void Qrqp::codegen_body(CodeGenerator& g) const {
+    g.add_auxiliary(CodeGenerator::AUX_QP);
+    g.local("p", "struct casadi_qp_prob");
+    g.local("d", "struct casadi_qp_data");
+    g.local("iter", "casadi_int");
+    g.local("index", "casadi_int");
+    g.local("sign", "casadi_int");
+    g.local("r_index", "casadi_int");
+    g.local("r_sign", "casadi_int");
+
+    // Problem structure
+    g.comment("Setup problem structure");
+    g << "p.du_to_pr = " << g.constant(du_to_pr_) << ";\n";
+    g << "p.print_iter = 0;\n";
+    g << "p.sp_a = " << g.sparsity(A_) << ";\n";
+    g << "p.sp_h = " << g.sparsity(H_) << ";\n";
+    g << "p.sp_at = " << g.sparsity(AT_) << ";\n";
+    g << "p.sp_kkt = " << g.sparsity(kkt_) << ";\n";
+    g << "p.sp_v = " << g.sparsity(sp_v_) << ";\n";
+    g << "p.sp_r = " << g.sparsity(sp_r_) << ";\n";
+    g << "p.prinv = " << g.constant(prinv_) << ";\n";
+    g << "p.pc = " << g.constant(pc_) << ";\n";
+    g << "p.dmin = " << g.constant(std::numeric_limits<double>::min()) << ";\n";
+    g << "p.inf = " << g.constant(inf) << ";\n";
+    g << "p.nx = " << nx_ << ";\n";
+    g << "p.na = " << na_ << ";\n";
+    g << "p.nz = " << nx_+na_ << ";\n";
+
+    // Setup data structure
+    g.comment("Setup data structure");
+    g << "d.prob = &p;\n";
+    g << "d.nz_h = arg[" << CONIC_H << "];\n";
+    g << "d.g = arg[" << CONIC_G << "];\n";
+    g << "d.nz_a = arg[" << CONIC_A << "];\n";
+    g << "casadi_qp_init(&d, iw, w);\n";
+
+    // Pass bounds and initial guess
+    g << g.copy("arg[" + str(CONIC_LBX) + "]", nx_, "d.lbz") << "\n";
+    g << g.copy("arg[" + str(CONIC_LBA) + "]", na_, "d.lbz+" + str(nx_)) << "\n";
+    g << g.copy("arg[" + str(CONIC_UBX) + "]", nx_, "d.ubz") << "\n";
+    g << g.copy("arg[" + str(CONIC_UBA) + "]", na_, "d.ubz+" + str(nx_)) << "\n";
+    g << g.copy("arg[" + str(CONIC_X0) + "]", nx_, "d.z") << "\n";
+    g << g.copy("arg[" + str(CONIC_LAM_X0) + "]", nx_, "d.lam") << "\n";
+    g << g.copy("arg[" + str(CONIC_LAM_A0) + "]", na_, "d.lam+" + str(nx_)) << "\n";
+    g << "if (casadi_qp_reset(&d)) return 1;\n";
+
+    // QP iterations, bounded by max_iter
+    g.comment("QP iterations");
+    g << "index = -2;\n";
+    g << "sign = 0;\n";
+    g << "r_index = -2;\n";
+    g << "r_sign = 0;\n";
+    g << "iter = 0;\n";
+    g << "while (1) {\n";
+    g << "casadi_qp_calc_dependent(&d);\n";
+    g << "casadi_qp_flip(&d, &index, &sign, r_index, r_sign);\n";
+    g << "casadi_qp_factorize(&d);\n";
+    g << "if (index==-1 || iter>=" << max_iter_ << ") break;\n";
+    g << "iter++;\n";
+    g << "if (casadi_qp_calc_step(&d, &r_index, &r_sign)) break;\n";
+    g << "casadi_qp_linesearch(&d, &index, &sign);\n";
+    g << "}\n";
+
+    // Get solution
+    g.comment("Get solution");
+    g << g.copy("&d.f", 1, "res[" + str(CONIC_COST) + "]") << "\n";
+    g << g.copy("d.z", nx_, "res[" + str(CONIC_X) + "]") << "\n";
+    g << g.copy("d.lam", nx_, "res[" + str(CONIC_LAM_X) + "]") << "\n";
+    g << g.copy("d.lam+" + str(nx_), na_, "res[" + str(CONIC_LAM_A) + "]") << "\n";
+  }
+
   Dict Qrqp::get_stats(void* mem) const {
     Dict stats = Conic::get_stats(mem);
     auto m = static_cast<QrqpMemory*>(mem);
@@ -58,15 +58,12 @@ namespace casadi {
   ShellCompiler::ShellCompiler(const std::string& name) :
     ImporterInternal(name) {
       handle_ = nullptr;
+      cleanup_ = false;
+      pgo_ = false;
   }
 
   ShellCompiler::~ShellCompiler() {
-    // Unload
-#ifdef _WIN32
-    if (handle_) FreeLibrary(handle_);
-#else // _WIN32
-    if (handle_) dlclose(handle_);
-#endif // _WIN32
+    unload();
 
     if (cleanup_) {
       if (remove(bin_name_.c_str())) casadi_warning("Failed to remove " + bin_name_);
@@ -75,9 +72,22 @@ namespace casadi {
         std::string name = base_name_+s;
         remove(name.c_str());
       }
+      if (pgo_) {
+        std::string name = base_name_ + ".gcda";
+        remove(name.c_str());
+      }
     }
   }
 
+  void ShellCompiler::unload() {
+#ifdef _WIN32
+    if (handle_) FreeLibrary(handle_);
+#else // _WIN32
+    if (handle_) dlclose(handle_);
+#endif // _WIN32
+    handle_ = nullptr;
+  }
+
   Options ShellCompiler::options_
   = {{&ImporterInternal::options_},
      {{"compiler",
@@ -119,7 +129,19 @@ namespace casadi {
        "Linker flag to denote shared library output. Default: '-o '"}},
       {"extra_suffixes",
        {OT_STRINGVECTOR,
-       "List of suffixes for extra files that the compiler may generate. Default: None"}}
+       "List of suffixes for extra files that the compiler may generate. Default: None"}},
+      {"pgo",
+       {OT_BOOL,
+       "Build an instrumented library for profile-guided optimization. "
+       "After representative evaluations, use_profile() rebuilds it using the profile. "
+       "Default: false"}},
+      {"pgo_generate_flags",
+       {OT_STRINGVECTOR,
+       "Compiler and linker flags for the instrumented build. Default: '-fprofile-generate'"}},
+      {"pgo_use_flags",
+       {OT_STRINGVECTOR,
+       "Compiler and linker flags for the build using the profile. "
+       "Default: '-fprofile-use -fprofile-correction'"}}
      }
   };
 
@@ -130,6 +152,9 @@ namespace casadi {
     // Default options
 
     cleanup_ = true;
+    pgo_ = false;
+    pgo_generate_flags_ = {"-fprofile-generate"};
+    pgo_use_flags_ = {"-fprofile-use", "-fprofile-correction"};
 
     vector<string> compiler_flags;
     vector<string> linker_flags;
@@ -174,6 +199,12 @@ namespace casadi {
         linker_output_flag = op.second.to_string();
       } else if (op.first=="extra_suffixes") {
         extra_suffixes_ = op.second.to_string_vector();
+      } else if (op.first=="pgo") {
+        pgo_ = op.second;
+      } else if (op.first=="pgo_generate_flags") {
+        pgo_generate_flags_ = op.second;
+      } else if (op.first=="pgo_use_flags") {
+        pgo_use_flags_ = op.second;
       }
     }
 
@@ -200,19 +231,10 @@ namespace casadi {
     for (vector<string>::const_iterator i=compiler_flags.begin(); i!=compiler_flags.end(); ++i) {
       cccmd << " " << *i;
     }
-    cccmd << " " << compiler_setup;
+    cc_prefix_ = cccmd.str();
 
-    // C/C++ source file
-    cccmd << " " << name_;
-
-    // Temporary object file
-    cccmd << " " + compiler_output_flag << obj_name_;
-
-    // Compile into an object
-    if (verbose_) uout() << "calling \"" << cccmd.str() + "\"" << std::endl;
-    if (system(cccmd.str().c_str())) {
-      casadi_error("Compilation failed. Tried \"" + cccmd.str() + "\"");
-    }
+    // C/C++ source file and temporary object file
+    cc_suffix_ = " " + compiler_setup + " " + name_ + " " + compiler_output_flag + obj_name_;
 
     // Link step
     stringstream ldcmd;
@@ -220,15 +242,31 @@ namespace casadi {
     for (vector<string>::const_iterator i=linker_flags.begin(); i!=linker_flags.end(); ++i) {
       ldcmd << " " << *i;
     }
-    ldcmd << " " << linker_setup;
+    ld_prefix_ = ldcmd.str();
 
     // Temporary file
-    ldcmd << " " << obj_name_ << " " + linker_output_flag + bin_name_;
+    ld_suffix_ = " " + linker_setup + " " + obj_name_ + " " + linker_output_flag + bin_name_;
+
+    // Compile, link and load
+    build(pgo_ ? pgo_generate_flags_ : vector<string>());
+  }
+
+  void ShellCompiler::build(const std::vector<std::string>& extra_flags) {
+    string flags;
+    for (const string& f : extra_flags) flags += " " + f;
+
+    // Compile into an object
+    string cccmd = cc_prefix_ + flags + cc_suffix_;
+    if (verbose_) uout() << "calling \"" << cccmd + "\"" << std::endl;
+    if (system(cccmd.c_str())) {
+      casadi_error("Compilation failed. Tried \"" + cccmd + "\"");
+    }
 
     // Compile into a shared library
-    if (verbose_) uout() << "calling \"" << ldcmd.str() << "\"" << std::endl;
-    if (system(ldcmd.str().c_str())) {
-      casadi_error("Linking failed. Tried \"" + ldcmd.str() + "\"");
+    string ldcmd = ld_prefix_ + flags + ld_suffix_;
+    if (verbose_) uout() << "calling \"" << ldcmd << "\"" << std::endl;
+    if (system(ldcmd.c_str())) {
+      casadi_error("Linking failed. Tried \"" + ldcmd + "\"");
     }
 
 #ifdef _WIN32
@@ -249,6 +287,14 @@ namespace casadi {
 #endif // _WIN32
   }
 
+  void ShellCompiler::use_profile() {
+    casadi_assert(pgo_, "No instrumented build, set option 'pgo'");
+    // Unloading the instrumented library writes the profile
+    unload();
+    // Same object file name, so that the profile is found
+    build(pgo_use_flags_);
+  }
+
   signal_t ShellCompiler::get_function(const std::string& symname) {
 #ifdef _WIN32
     return (signal_t)GetProcAddress(handle_, TEXT(symname.c_str()));
@@ -81,7 +81,23 @@ namespace casadi {
 
     /// Get a function pointer for numerical evaluation
     signal_t get_function(const std::string& symname) override;
+
+    /// Rebuild the instrumented library using the collected profile
+    void use_profile() override;
   protected:
+    /// Compile, link and load the library
+    void build(const std::vector<std::string>& extra_flags);
+
+    /// Unload the library
+    void unload();
+
+    /// Compiler and linker commands, extra flags go in between
+    std::string cc_prefix_, cc_suffix_, ld_prefix_, ld_suffix_;
+
+    /// Profile-guided optimization
+    bool pgo_;
+    std::vector<std::string> pgo_generate_flags_, pgo_use_flags_;
+
     std::string base_name_;
 
     /// Temporary file
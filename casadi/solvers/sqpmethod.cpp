@@ -34,6 +34,7 @@
 #include <fstream>
 #include <cmath>
 #include <cfloat>
+#include <algorithm>
 
 using namespace std;
 namespace casadi {
@@ -72,7 +73,9 @@ namespace casadi {
         "Options to be passed to the QP solver"}},
       {"hessian_approximation",
        {OT_STRING,
-        "limited-memory|exact"}},
+        "limited-memory|exact|gauss-newton. The Gauss-Newton approximation "
+        "2*J_r'*J_r requires the objective to be sumsqr(r) for a residual "
+        "output 'r' of the NLP"}},
       {"max_iter",
        {OT_INT,
         "Maximum number of SQP iterations"}},
@@ -100,6 +103,17 @@ namespace casadi {
       {"lbfgs_memory",
        {OT_INT,
         "Size of L-BFGS memory."}},
+      {"partitioned_bfgs",
+       {OT_BOOL,
+        "Use a block-diagonal (partitioned) BFGS approximation with one dense update "
+        "per group of coupled variables. Groups are detected from the structural sparsity "
+        "of the Lagrangian Hessian unless 'bfgs_blocks' is given. "
+        "Requires hessian_approximation 'limited-memory' [false]"}},
+      {"bfgs_blocks",
+       {OT_INTVECTORVECTOR,
+        "User-provided disjoint groups of variable indices for the partitioned BFGS "
+        "approximation. Variables not in any group get a block of their own. "
+        "Implies 'partitioned_bfgs'"}},
       {"regularize",
        {OT_BOOL,
         "Automatic regularization of Lagrange Hessian."}},
@@ -133,6 +147,8 @@ namespace casadi {
     tol_pr_ = 1e-6;
     tol_du_ = 1e-6;
     regularize_ = false;
+    partitioned_bfgs_ = false;
+    std::vector<std::vector<casadi_int> > bfgs_blocks;
     string hessian_approximation = "exact";
     min_step_size_ = 1e-10;
     string qpsol_plugin = "qpoases";
@@ -171,6 +187,11 @@ namespace casadi {
         qpsol_options = op.second;
       } else if (op.first=="regularize") {
         regularize_ = op.second;
+      } else if (op.first=="partitioned_bfgs") {
+        partitioned_bfgs_ = op.second;
+      } else if (op.first=="bfgs_blocks") {
+        bfgs_blocks = op.second;
+        partitioned_bfgs_ = true;
       } else if (op.first=="print_header") {
         print_header_ = op.second;
       } else if (op.first=="print_iteration") {
@@ -183,6 +204,14 @@ namespace casadi {
     // Use exact Hessian?
     exact_hessian_ = hessian_approximation =="exact";
 
+    // Use Gauss-Newton Hessian?
+    gauss_newton_ = hessian_approximation =="gauss-newton";
+    casadi_assert(exact_hessian_ || gauss_newton_ || hessian_approximation=="limited-memory",
+      "Unknown hessian_approximation '" + hessian_approximation + "'");
+    casadi_assert(!partitioned_bfgs_ || hessian_approximation=="limited-memory",
+      "'partitioned_bfgs' and 'bfgs_blocks' require hessian_approximation 'limited-memory', "
+      "got '" + hessian_approximation + "'");
+
     // Get/generate required functions
     create_function("nlp_fg", {"x", "p"}, {"f", "g"});
     // First order derivative information
@@ -194,6 +223,85 @@ namespace casadi {
       Function hess_l_fcn = create_function("nlp_hess_l", {"x", "p", "lam:f", "lam:g"},
                                            {"sym:hess:gamma:x:x"}, {{"gamma", {"f", "g"}}});
       Hsp_ = hess_l_fcn.sparsity_out(0);
+    } else if (gauss_newton_) {
+      const std::vector<std::string>& onames = oracle_.name_out();
+      casadi_assert(std::find(onames.begin(), onames.end(), "r")!=onames.end(),
+        "Gauss-Newton Hessian approximation requires a residual output 'r'");
+      Function jac_r_fcn = create_function("nlp_jac_r", {"x", "p"}, {"jac:r:x"});
+      Jrsp_ = jac_r_fcn.sparsity_out(0);
+      JrTsp_ = Jrsp_.T();
+      Hsp_ = Sparsity::mtimes(JrTsp_, Jrsp_);
+      // Work vectors for forming J_r'*J_r
+      alloc_iw(Jrsp_.size1());
+      alloc_w(nx_);
+    } else if (partitioned_bfgs_) {
+      if (bfgs_blocks.empty()) {
+        // Structural sparsity of the Lagrangian Hessian, without forming it
+        std::vector<casadi_int> r, c;
+        Sparsity Hf = jac_g_fcn.sparsity_jac(0, 1);
+        Hf.get_triplet(r, c);
+        if (ng_>0) {
+          // Jacobian nonzero (i, j) depending on x_k contributes to (j, k)
+          std::vector<casadi_int> rg, cg;
+          jac_g_fcn.sparsity_jac(0, 3).get_triplet(rg, cg);
+          for (casadi_int k=0; k<rg.size(); ++k) {
+            r.push_back(rg[k] / ng_);
+            c.push_back(cg[k]);
+          }
+        }
+        Sparsity Hl = Sparsity::triplet(nx_, nx_, r, c);
+        Hl = Hl + Hl.T() + Sparsity::diag(nx_);
+        // Connected components are the groups
+        std::vector<casadi_int> index, offset;
+        casadi_int nb = Hl.scc(index, offset);
+        for (casadi_int b=0; b<nb; ++b) {
+          bfgs_blocks.push_back(std::vector<casadi_int>(index.begin()+offset[b],
+                                                        index.begin()+offset[b+1]));
+        }
+      } else {
+        // Add missing variables as blocks of their own
+        std::vector<bool> covered(nx_, false);
+        for (auto&& b : bfgs_blocks) {
+          for (casadi_int i : b) {
+            casadi_assert(i>=0 && i<nx_, "'bfgs_blocks' index out of bounds");
+            casadi_assert(!covered[i], "'bfgs_blocks' must be disjoint");
+            covered[i] = true;
+          }
+        }
+        for (casadi_int i=0; i<nx_; ++i) {
+          if (!covered[i]) bfgs_blocks.push_back({i});
+        }
+      }
+      // Assemble block-diagonal Hessian sparsity
+      std::vector<casadi_int> r, c;
+      bfgs_offset_ = {0};
+      bfgs_ind_.clear();
+      bfgs_max_block_ = 0;
+      for (auto&& b : bfgs_blocks) {
+        std::vector<casadi_int> ind = b;
+        std::sort(ind.begin(), ind.end());
+        for (casadi_int j : ind) {
+          for (casadi_int i : ind) {
+            r.push_back(i);
+            c.push_back(j);
+          }
+        }
+        bfgs_ind_.insert(bfgs_ind_.end(), ind.begin(), ind.end());
+        bfgs_offset_.push_back(bfgs_ind_.size());
+        bfgs_max_block_ = std::max(bfgs_max_block_, static_cast<casadi_int>(ind.size()));
+      }
+      Hsp_ = Sparsity::triplet(nx_, nx_, r, c);
+      // Location of each dense block in the nonzeros, column-major
+      bfgs_nz_.resize(r.size());
+      for (casadi_int k=0; k<r.size(); ++k) bfgs_nz_[k] = Hsp_.get_nz(r[k], c[k]);
+      // Dense sparsity patterns of the blocks
+      bfgs_sp_.clear();
+      for (casadi_int b=0; b+1<bfgs_offset_.size(); ++b) {
+        casadi_int n = bfgs_offset_[b+1]-bfgs_offset_[b];
+        bfgs_sp_.push_back(Sparsity::dense(n, n));
+      }
+      // Block of the Hessian, step and gradients, casadi_bfgs
+      alloc_w(bfgs_max_block_*bfgs_max_block_ + 5*bfgs_max_block_);
     } else {
       Hsp_ = Sparsity::dense(nx_, nx_);
     }
@@ -206,7 +314,7 @@ namespace casadi {
     alloc(qpsol_);
 
     // BFGS?
-    if (!exact_hessian_) {
+    if (!exact_hessian_ && !gauss_newton_ && !partitioned_bfgs_) {
       alloc_w(2*nx_); // casadi_bfgs
     }
 
@@ -216,6 +324,11 @@ namespace casadi {
       print("This is casadi::Sqpmethod.\n");
       if (exact_hessian_) {
         print("Using exact Hessian\n");
+      } else if (gauss_newton_) {
+        print("Using Gauss-Newton Hessian approximation\n");
+      } else if (partitioned_bfgs_) {
+        print("Using partitioned BFGS Hessian approximation (%lld blocks)\n",
+              static_cast<casadi_int>(bfgs_offset_.size()-1));
       } else {
         print("Using limited memory BFGS Hessian approximation\n");
       }
@@ -256,6 +369,12 @@ namespace casadi {
     // Jacobian
     alloc_w(Asp_.nnz(), true); // Jk_
 
+    // Residual Jacobian and its transpose
+    if (gauss_newton_) {
+      alloc_w(Jrsp_.nnz(), true); // Jr_
+      alloc_w(Jrsp_.nnz(), true); // JrT_
+    }
+
     // Line-search memory
     alloc_w(merit_memsize_, true);
   }
@@ -297,6 +416,12 @@ namespace casadi {
     // Jacobian
     m->Jk = w; w += Asp_.nnz();
 
+    // Residual Jacobian and its transpose
+    if (gauss_newton_) {
+      m->Jr = w; w += Jrsp_.nnz();
+      m->JrT = w; w += Jrsp_.nnz();
+    }
+
     // merit_mem
     m->merit_mem = w; w += merit_memsize_;
 
@@ -353,6 +478,7 @@ namespace casadi {
       double dx_norminf = casadi_norm_inf(nx_, m->dx);
 
       // Printing information about the actual iterate
+      Logger::iteration("sqpmethod", m->iter_count, m->f, pr_inf, gLag_norminf);
       if (print_iteration_) {
         if (m->iter_count % 10 == 0) print_iteration();
         print_iteration(m->iter_count, m->f, pr_inf, gLag_norminf, dx_norminf,
@@ -402,6 +528,16 @@ namespace casadi {
           m->reg = std::fmin(0, -casadi_lb_eig(Hsp_, m->Bk));
           if (m->reg > 0) casadi_regularize(Hsp_, m->Bk, m->reg);
         }
+      } else if (gauss_newton_) {
+        // Gauss-Newton Hessian: 2*J_r'*J_r, no second order derivatives needed
+        m->arg[0] = m->x;
+        m->arg[1] = m->p;
+        m->res[0] = m->Jr;
+        if (calc_function(m, "nlp_jac_r")) return 1;
+        casadi_trans(m->Jr, Jrsp_, m->JrT, JrTsp_, m->iw);
+        casadi_fill(m->Bk, Hsp_.nnz(), 0.);
+        casadi_mtimes(m->JrT, JrTsp_, m->Jr, Jrsp_, m->Bk, Hsp_, m->w, false);
+        casadi_scal(Hsp_.nnz(), 2., m->Bk);
       } else if (m->iter_count==0) {
         // Initialize BFGS
         casadi_fill(m->Bk, Hsp_.nnz(), 1.);
@@ -410,7 +546,11 @@ namespace casadi {
         // Update BFGS
         if (m->iter_count % lbfgs_memory_ == 0) casadi_bfgs_reset(Hsp_, m->Bk);
         // Update the Hessian approximation
-        casadi_bfgs(Hsp_, m->Bk, m->dx, m->gLag, m->gLag_old, m->w);
+        if (partitioned_bfgs_) {
+          bfgs_partitioned(m);
+        } else {
+          casadi_bfgs(Hsp_, m->Bk, m->dx, m->gLag, m->gLag_old, m->w);
+        }
       }
 
       // Formulate the QP
@@ -533,7 +673,7 @@ namespace casadi {
       // Take step
       casadi_axpy(nx_, 1., m->dx, m->x);
 
-      if (!exact_hessian_) {
+      if (!exact_hessian_ && !gauss_newton_) {
         // Evaluate the gradient of the Lagrangian with the old x but new lam_g (for BFGS)
         casadi_copy(m->gf, nx_, m->gLag_old);
         casadi_mv(m->Jk, Asp_, m->lam_g, m->gLag_old, true);
@@ -544,6 +684,292 @@ namespace casadi {
     return 0;
   }
 
+  bool Sqpmethod::has_codegen() const {
+    // Partitioned BFGS updates are only implemented in C++
+    if (partitioned_bfgs_) return false;
+    // All functions called from the generated code
+    std::vector<std::string> fname = {"nlp_fg", "nlp_jac_fg"};
+    if (exact_hessian_) fname.push_back("nlp_hess_l");
+    if (gauss_newton_) fname.push_back("nlp_jac_r");
+    for (auto&& f : fname) {
+      if (!get_function(f)->has_codegen()) return false;
+    }
+    return qpsol_->has_codegen();
+  }
+
+  void Sqpmethod::codegen_declarations(CodeGenerator& g) const {
+    Nlpsol::codegen_declarations(g);
+    g.add_dependency(get_function("nlp_fg"));
+    g.add_dependency(get_function("nlp_jac_fg"));
+    if (exact_hessian_) g.add_dependency(get_function("nlp_hess_l"));
+    if (gauss_newton_) g.add_dependency(get_function("nlp_jac_r"));
+    g.add_dependency(qpsol_);
+  }
+
+  void Sqpmethod::codegen_body(CodeGenerator& g) const {
+    casadi_assert(!partitioned_bfgs_,
+      "Code generation not supported for 'partitioned_bfgs'");
+    g.add_auxiliary(CodeGenerator::AUX_MAX_VIOL);
+    g.add_auxiliary(CodeGenerator::AUX_NORM_INF);
+    g.add_auxiliary(CodeGenerator::AUX_FMAX);
+    g.add_auxiliary(CodeGenerator::AUX_FMIN);
+
+    // Work vectors, input checks and initial guess
+    codegen_body_enter(g);
+
+    // Work vectors, same order as in set_work
+    for (const char* v : {"x_cand", "gLag", "g_cand", "gf", "qp_LBA", "qp_UBA",
+                          "qp_LBX", "qp_UBX", "dx", "qp_DUAL_X", "qp_DUAL_A", "Bk", "Jk",
+                          "merit_mem"}) {
+      g.local(v, "casadi_real", "*");
+    }
+    g << "x_cand = w; w += " << nx_ << ";\n";
+    g << "gLag = w; w += " << nx_ << ";\n";
+    if (exact_hessian_ || gauss_newton_) {
+      g << "w += " << nx_ << ";\n";
+    } else {
+      g.local("gLag_old", "casadi_real", "*");
+      g << "gLag_old = w; w += " << nx_ << ";\n";
+    }
+    g << "g_cand = w; w += " << ng_ << ";\n";
+    g << "gf = w; w += " << nx_ << ";\n";
+    g << "qp_LBA = w; w += " << ng_ << ";\n";
+    g << "qp_UBA = w; w += " << ng_ << ";\n";
+    g << "qp_LBX = w; w += " << nx_ << ";\n";
+    g << "qp_UBX = w; w += " << nx_ << ";\n";
+    g << "dx = w; w += " << nx_ << ";\n";
+    g << "qp_DUAL_X = w; w += " << nx_ << ";\n";
+    g << "qp_DUAL_A = w; w += " << ng_ << ";\n";
+    g << "Bk = w; w += " << Hsp_.nnz() << ";\n";
+    g << "Jk = w; w += " << Asp_.nnz() << ";\n";
+    if (gauss_newton_) {
+      g.local("Jr", "casadi_real", "*");
+      g.local("JrT", "casadi_real", "*");
+      g << "Jr = w; w += " << Jrsp_.nnz() << ";\n";
+      g << "JrT = w; w += " << Jrsp_.nnz() << ";\n";
+    }
+    g << "merit_mem = w; w += " << merit_memsize_ << ";\n";
+
+    // Scalars
+    for (const char* v : {"iter_count", "ls_iter", "merit_ind", "i"}) {
+      g.local(v, "casadi_int");
+    }
+    for (const char* v : {"sigma", "t", "pr_inf", "gLag_norminf", "dx_norminf",
+                          "l1_infeas", "F_sens", "L1dir", "L1merit", "meritmax", "fk_cand",
+                          "L1merit_cand"}) {
+      g.local(v, "casadi_real");
+    }
+
+    // Arguments and results of the called functions
+    std::string arg1 = "arg+" + str(n_in_), res1 = "res+" + str(n_out_);
+    std::string a = "arg[" + str(n_in_), r = "res[" + str(n_out_);
+
+    g << "iter_count = 0;\n";
+    g << "ls_iter = 0;\n";
+    g << "merit_ind = 0;\n";
+    g << "sigma = 0.;\n";
+    g << "t = 0.;\n";
+    if (exact_hessian_) {
+      g.local("one", "casadi_real");
+      g << "one = 1.;\n";
+    }
+    g << g.fill("dx", nx_, "0.") << "\n";
+
+    g.comment("MAIN OPTIMIZATION LOOP");
+    g << "while (1) {\n";
+    g.comment("Evaluate f, g and first order derivative information");
+    g << a << "] = d_x;\n";
+    g << a << "+1] = d_p;\n";
+    g << r << "] = &d_f;\n";
+    g << r << "+1] = gf;\n";
+    g << r << "+2] = d_g;\n";
+    g << r << "+3] = Jk;\n";
+    g << "if (" << g(get_function("nlp_jac_fg"), arg1, res1, "iw", "w", "0")
+      << ") return 1;\n";
+
+    g.comment("Evaluate the gradient of the Lagrangian");
+    g << g.copy("gf", nx_, "gLag") << "\n";
+    g << g.mv("Jk", Asp_, "d_lam_g", "gLag", true) << "\n";
+    g << g.axpy(nx_, "1.", "d_lam_x", "gLag") << "\n";
+
+    g.comment("Primal infeasability, inf-norm of Lagrange gradient and step");
+    g << "pr_inf = casadi_fmax(casadi_max_viol(" << nx_ << ", d_x, d_lbx, d_ubx), "
+      << "casadi_max_viol(" << ng_ << ", d_g, d_lbg, d_ubg));\n";
+    g << "gLag_norminf = casadi_norm_inf(" << nx_ << ", gLag);\n";
+    g << "dx_norminf = casadi_norm_inf(" << nx_ << ", dx);\n";
+
+    g.comment("Checking convergence criteria");
+    g << "if (iter_count >= " << min_iter_ << " && pr_inf < " << g.constant(tol_pr_)
+      << " && gLag_norminf < " << g.constant(tol_du_) << ") break;\n";
+    g << "if (iter_count >= " << max_iter_ << ") break;\n";
+    g << "if (iter_count >= 1 && iter_count >= " << min_iter_ << " && dx_norminf <= "
+      << g.constant(min_step_size_) << ") break;\n";
+
+    if (exact_hessian_) {
+      g.comment("Update/reset exact Hessian");
+      g << a << "] = d_x;\n";
+      g << a << "+1] = d_p;\n";
+      g << a << "+2] = &one;\n";
+      g << a << "+3] = d_lam_g;\n";
+      g << r << "] = Bk;\n";
+      g << "if (" << g(get_function("nlp_hess_l"), arg1, res1, "iw", "w", "0")
+        << ") return 1;\n";
+      if (regularize_) {
+        g.add_auxiliary(CodeGenerator::AUX_REGULARIZE);
+        g.local("reg", "casadi_real");
+        g << "reg = casadi_fmin(0, -casadi_lb_eig(" << g.sparsity(Hsp_) << ", Bk));\n";
+        g << "if (reg > 0) casadi_regularize(" << g.sparsity(Hsp_) << ", Bk, reg);\n";
+      }
+    } else if (gauss_newton_) {
+      g.comment("Gauss-Newton Hessian");
+      g << a << "] = d_x;\n";
+      g << a << "+1] = d_p;\n";
+      g << r << "] = Jr;\n";
+      g << "if (" << g(get_function("nlp_jac_r"), arg1, res1, "iw", "w", "0")
+        << ") return 1;\n";
+      g << g.trans("Jr", Jrsp_, "JrT", JrTsp_, "iw") << ";\n";
+      g << g.fill("Bk", Hsp_.nnz(), "0.") << "\n";
+      g << g.mtimes("JrT", JrTsp_, "Jr", Jrsp_, "Bk", Hsp_, "w", false) << "\n";
+      g << g.scal(Hsp_.nnz(), "2.", "Bk") << "\n";
+    } else {
+      g.add_auxiliary(CodeGenerator::AUX_BFGS);
+      g.comment("Initialize or update BFGS");
+      g << "if (iter_count==0) {\n";
+      g << g.fill("Bk", Hsp_.nnz(), "1.") << "\n";
+      g << "casadi_bfgs_reset(" << g.sparsity(Hsp_) << ", Bk);\n";
+      g << "} else {\n";
+      g << "if (iter_count % " << lbfgs_memory_ << " == 0) casadi_bfgs_reset("
+        << g.sparsity(Hsp_) << ", Bk);\n";
+      g << "casadi_bfgs(" << g.sparsity(Hsp_) << ", Bk, dx, gLag, gLag_old, w);\n";
+      g << "}\n";
+    }
+
+    g.comment("Formulate the QP");
+    g << g.copy("d_lbx", nx_, "qp_LBX") << "\n";
+    g << g.axpy(nx_, "-1.", "d_x", "qp_LBX") << "\n";
+    g << g.copy("d_ubx", nx_, "qp_UBX") << "\n";
+    g << g.axpy(nx_, "-1.", "d_x", "qp_UBX") << "\n";
+    g << g.copy("d_lbg", ng_, "qp_LBA") << "\n";
+    g << g.axpy(ng_, "-1.", "d_g", "qp_LBA") << "\n";
+    g << g.copy("d_ubg", ng_, "qp_UBA") << "\n";
+    g << g.axpy(ng_, "-1.", "d_g", "qp_UBA") << "\n";
+    g << g.copy("d_lam_x", nx_, "qp_DUAL_X") << "\n";
+    g << g.copy("d_lam_g", ng_, "qp_DUAL_A") << "\n";
+    g << g.fill("dx", nx_, "0.") << "\n";
+    g << "iter_count++;\n";
+
+    g.comment("Solve the QP");
+    g << "for (i=0; i<" << qpsol_.n_in() << "; ++i) " << a << "+i] = 0;\n";
+    g << a << "+" << CONIC_H << "] = Bk;\n";
+    g << a << "+" << CONIC_G << "] = gf;\n";
+    g << a << "+" << CONIC_X0 << "] = dx;\n";
+    g << a << "+" << CONIC_LAM_X0 << "] = qp_DUAL_X;\n";
+    g << a << "+" << CONIC_LAM_A0 << "] = qp_DUAL_A;\n";
+    g << a << "+" << CONIC_LBX << "] = qp_LBX;\n";
+    g << a << "+" << CONIC_UBX << "] = qp_UBX;\n";
+    g << a << "+" << CONIC_A << "] = Jk;\n";
+    g << a << "+" << CONIC_LBA << "] = qp_LBA;\n";
+    g << a << "+" << CONIC_UBA << "] = qp_UBA;\n";
+    g << "for (i=0; i<" << qpsol_.n_out() << "; ++i) " << r << "+i] = 0;\n";
+    g << r << "+" << CONIC_X << "] = dx;\n";
+    g << r << "+" << CONIC_LAM_X << "] = qp_DUAL_X;\n";
+    g << r << "+" << CONIC_LAM_A << "] = qp_DUAL_A;\n";
+    g << g(qpsol_, arg1, res1, "iw", "w", "0") << ";\n";
+
+    g.comment("Calculate penalty parameter of merit function");
+    g << "sigma = casadi_fmax(sigma, 1.01*casadi_norm_inf(" << nx_ << ", qp_DUAL_X));\n";
+    g << "sigma = casadi_fmax(sigma, 1.01*casadi_norm_inf(" << ng_ << ", qp_DUAL_A));\n";
+
+    g.comment("Calculate L1-merit function in the actual iterate");
+    g << "l1_infeas = casadi_fmax(casadi_max_viol(" << nx_ << ", d_x, d_lbx, d_ubx), "
+      << "casadi_max_viol(" << ng_ << ", d_g, d_lbg, d_ubg));\n";
+    g << "F_sens = " << g.dot(nx_, "dx", "gf") << ";\n";
+    g << "L1dir = F_sens - sigma * l1_infeas;\n";
+    g << "L1merit = d_f + sigma * l1_infeas;\n";
+    g << "merit_mem[merit_ind] = L1merit;\n";
+    g << "merit_ind = (merit_ind+1) % " << merit_memsize_ << ";\n";
+    g << "meritmax = merit_mem[0];\n";
+    g << "for (i=1; i<" << merit_memsize_ << " && i<iter_count; ++i) {\n";
+    g << "if (meritmax < merit_mem[i]) meritmax = merit_mem[i];\n";
+    g << "}\n";
+
+    g << "t = 1.0;\n";
+    g << "ls_iter = 0;\n";
+    if (max_iter_ls_>0) {
+      g.comment("Line-search, bounded by max_iter_ls");
+      g << "while (1) {\n";
+      g << "ls_iter++;\n";
+      g << g.copy("d_x", nx_, "x_cand") << "\n";
+      g << g.axpy(nx_, "t", "dx", "x_cand") << "\n";
+      g << a << "] = x_cand;\n";
+      g << a << "+1] = d_p;\n";
+      g << r << "] = &fk_cand;\n";
+      g << r << "+1] = g_cand;\n";
+      g << "if (" << g(get_function("nlp_fg"), arg1, res1, "iw", "w", "0") << "==0) {\n";
+      g << "l1_infeas = casadi_fmax(casadi_max_viol(" << nx_ << ", x_cand, d_lbx, d_ubx), "
+        << "casadi_max_viol(" << ng_ << ", g_cand, d_lbg, d_ubg));\n";
+      g << "L1merit_cand = fk_cand + sigma * l1_infeas;\n";
+      g << "if (L1merit_cand <= meritmax + t * " << g.constant(c1_) << " * L1dir) break;\n";
+      g << "}\n";
+      g << "if (ls_iter == " << max_iter_ls_ << ") break;\n";
+      g << "t = " << g.constant(beta_) << " * t;\n";
+      g << "}\n";
+      g.comment("Candidate accepted, update dual variables");
+      g << g.scal(ng_, "1-t", "d_lam_g") << "\n";
+      g << g.axpy(ng_, "t", "qp_DUAL_A", "d_lam_g") << "\n";
+      g << g.scal(nx_, "1-t", "d_lam_x") << "\n";
+      g << g.axpy(nx_, "t", "qp_DUAL_X", "d_lam_x") << "\n";
+      g << g.scal(nx_, "t", "dx") << "\n";
+    } else {
+      g.comment("Full step");
+      g << g.copy("qp_DUAL_A", ng_, "d_lam_g") << "\n";
+      g << g.copy("qp_DUAL_X", nx_, "d_lam_x") << "\n";
+    }
+
+    g.comment("Take step");
+    g << g.axpy(nx_, "1.", "dx", "d_x") << "\n";
+    if (!exact_hessian_ && !gauss_newton_) {
+      g << g.copy("gf", nx_, "gLag_old") << "\n";
+      g << g.mv("Jk", Asp_, "d_lam_g", "gLag_old", true) << "\n";
+      g << g.axpy(nx_, "1.", "d_lam_x", "gLag_old") << "\n";
+    }
+    g << "}\n";
+
+    // Multipliers, bounds consistency and outputs
+    codegen_body_exit(g);
+  }
+
+  void Sqpmethod::bfgs_partitioned(SqpmethodMemory* m) const {
+    // Work vectors
+    double* w = m->w;
+    double* hb = w; w += bfgs_max_block_*bfgs_max_block_;
+    double* dxb = w; w += bfgs_max_block_;
+    double* gb = w; w += bfgs_max_block_;
+    double* gb_old = w; w += bfgs_max_block_;
+    // Dense BFGS update for each block
+    const casadi_int* nz = get_ptr(bfgs_nz_);
+    for (casadi_int b=0; b<bfgs_sp_.size(); ++b) {
+      const casadi_int* ind = get_ptr(bfgs_ind_) + bfgs_offset_[b];
+      casadi_int n = bfgs_offset_[b+1] - bfgs_offset_[b];
+      // Gather
+      for (casadi_int i=0; i<n; ++i) {
+        dxb[i] = m->dx[ind[i]];
+        gb[i] = m->gLag[ind[i]];
+        gb_old[i] = m->gLag_old[ind[i]];
+      }
+      // Skip blocks that did not move
+      if (casadi_norm_inf(n, dxb)==0) {
+        nz += n*n;
+        continue;
+      }
+      for (casadi_int k=0; k<n*n; ++k) hb[k] = m->Bk[nz[k]];
+      casadi_bfgs(bfgs_sp_[b], hb, dxb, gb, gb_old, w);
+      // Scatter
+      for (casadi_int k=0; k<n*n; ++k) m->Bk[nz[k]] = hb[k];
+      nz += n*n;
+    }
+  }
+
   void Sqpmethod::print_iteration() const {
     print("%4s %14s %9s %9s %9s %7s %2s\n", "iter", "objective", "inf_pr",
           "inf_du", "||d||", "lg(rg)", "ls");
@@ -592,10 +1018,17 @@ namespace casadi {
     if (verbose_) print("QP solved\n");
   }
 
+  Dict Sqpmethod::memory_footprint() const {
+    Dict fp = Nlpsol::memory_footprint();
+    if (!qpsol_.is_null()) add_footprint(fp, "qpsol", qpsol_->memory_footprint());
+    return fp;
+  }
+
   Dict Sqpmethod::get_stats(void* mem) const {
     Dict stats = Nlpsol::get_stats(mem);
     auto m = static_cast<SqpmethodMemory*>(mem);
-    stats["return_status"] = m->return_status;
+    // Not set if the solver was evaluated in generated code
+    if (m->return_status) stats["return_status"] = m->return_status;
     stats["iter_count"] = m->iter_count;
     return stats;
   }
@@ -60,6 +60,9 @@ namespace casadi {
     // Current Jacobian
     double *Jk;
 
+    // Residual Jacobian and its transpose (Gauss-Newton)
+    double *Jr, *JrT;
+
     /// Current Hessian approximation
     double *Bk;
 
@@ -109,6 +112,9 @@ namespace casadi {
     /// Get all statistics
     Dict get_stats(void* mem) const override;
 
+    /** \brief Estimate the memory used, in bytes */
+    Dict memory_footprint() const override;
+
     // Initialize the solver
     void init(const Dict& opts) override;
 
@@ -125,12 +131,30 @@ namespace casadi {
     // Solve the NLP
     int solve(void* mem) const override;
 
+    /** \brief Is codegen supported? */
+    bool has_codegen() const override;
+
+    /** \brief Generate code for the declarations of the C function */
+    void codegen_declarations(CodeGenerator& g) const override;
+
+    /** \brief Generate code for the function body */
+    void codegen_body(CodeGenerator& g) const override;
+
     /// QP solver for the subproblems
     Function qpsol_;
 
     /// Exact Hessian?
     bool exact_hessian_;
 
+    /// Gauss-Newton Hessian approximation?
+    bool gauss_newton_;
+
+    /// Partitioned BFGS: variable groups, offsets, Hessian nonzeros and pattern per block
+    bool partitioned_bfgs_;
+    std::vector<casadi_int> bfgs_ind_, bfgs_offset_, bfgs_nz_;
+    std::vector<Sparsity> bfgs_sp_;
+    casadi_int bfgs_max_block_;
+
     /// Maximum, minimum number of SQP iterations
     casadi_int max_iter_, min_iter_;
 
@@ -160,6 +184,9 @@ namespace casadi {
     // Jacobian sparsity
     Sparsity Asp_;
 
+    // Residual Jacobian sparsity and its transpose (Gauss-Newton)
+    Sparsity Jrsp_, JrTsp_;
+
     /// Regularization
     bool regularize_;
 
@@ -173,6 +200,9 @@ namespace casadi {
     void print_iteration(casadi_int iter, double obj, double pr_inf, double du_inf,
                          double dx_norm, double reg, casadi_int ls_trials, bool ls_success) const;
 
+    /// Dense BFGS update of each diagonal block of the Hessian approximation
+    void bfgs_partitioned(SqpmethodMemory* m) const;
+
     // Solve the QP subproblem
     virtual void solve_QP(SqpmethodMemory* m, const double* H, const double* g,
                           const double* lbx, const double* ubx,
@@ -0,0 +1,162 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/** \brief Round trip of the .nl and .sol files of the AMPL interface
+
+    The executable doubles as the AMPL solver: called with "-o<sol> <nl>",
+    it checks the header of the .nl file, reads the initial guess and writes
+    a .sol file in the same format, binary or text. The solution returned is
+    the initial guess plus one, with multipliers 1, 2, ... for the constraints.
+*/
+
+#include <casadi/casadi.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace casadi;
+
+// Write a record of a binary .sol file, enclosed by its length
+void write_record(std::ofstream& sol, const void* data, int len) {
+  sol.write(reinterpret_cast<const char*>(&len), sizeof(int));
+  sol.write(reinterpret_cast<const char*>(data), len);
+  sol.write(reinterpret_cast<const char*>(&len), sizeof(int));
+}
+
+// Act as the AMPL solver
+int fake_solver(const std::string& solname, const std::string& nlname) {
+  std::ifstream nl(nlname, std::ifstream::in | std::ifstream::binary);
+  casadi_assert(nl.is_open(), "Failed to open " + nlname);
+  std::stringstream ss;
+  ss << nl.rdbuf();
+  std::string buf = ss.str();
+
+  // Text header, also for the binary format
+  std::istringstream header(buf);
+  std::string line;
+  std::getline(header, line);
+  casadi_assert(line[0]=='b' || line[0]=='g', "Unknown .nl format: " + line);
+  bool binary = line[0]=='b';
+  casadi_int nx, ng, dummy, arith;
+  header >> nx >> ng;
+  std::getline(header, line);
+  for (casadi_int k=0; k<3; ++k) std::getline(header, line);
+  header >> dummy >> dummy >> arith;
+
+  // Arithmetic field: byte order of the binary data, 0 for text
+  int one = 1;
+  casadi_int native = *reinterpret_cast<char*>(&one)==1 ? 1 : 2;
+  casadi_assert(arith==(binary ? native : 0), "Wrong arithmetic field: " + str(arith));
+
+  // Initial guess
+  std::vector<double> x(nx);
+  if (binary) {
+    // Fixed length 'x', 'r' and 'b' segments at the end of the file
+    size_t pos = buf.size() - (1 + 17*nx) - (1 + 17*ng) - (1 + sizeof(int) + 12*nx);
+    casadi_assert(buf[pos]=='x', "'x' segment not found");
+    pos += 1 + sizeof(int);
+    for (casadi_int i=0; i<nx; ++i) {
+      int ind;
+      memcpy(&ind, &buf[pos], sizeof(int));
+      memcpy(&x.at(ind), &buf[pos + sizeof(int)], sizeof(double));
+      pos += sizeof(int) + sizeof(double);
+    }
+  } else {
+    std::istringstream s(buf);
+    while (std::getline(s, line) && line[0]!='x') {}
+    for (casadi_int i=0; i<nx; ++i) {
+      casadi_int ind;
+      s >> ind;
+      s >> x.at(ind);
+    }
+  }
+
+  // Solution
+  for (double& e : x) e += 1;
+  std::vector<double> lam(ng);
+  for (casadi_int i=0; i<ng; ++i) lam[i] = static_cast<double>(i+1);
+
+  // Write the .sol file
+  std::string msg = "fake solver: done\n";
+  std::vector<int> opt = {3, 1, 1, 0};
+  std::ofstream sol(solname, std::ofstream::out | std::ofstream::binary);
+  casadi_assert(sol.is_open(), "Failed to open " + solname);
+  if (binary) {
+    write_record(sol, msg.data(), static_cast<int>(msg.size()));
+    // Options, followed by the number of constraints, duals, variables and primals
+    for (casadi_int n : {ng, ng, nx, nx}) opt.push_back(static_cast<int>(n));
+    write_record(sol, opt.data(), static_cast<int>(opt.size()*sizeof(int)));
+    if (ng>0) write_record(sol, lam.data(), static_cast<int>(ng*sizeof(double)));
+    write_record(sol, x.data(), static_cast<int>(nx*sizeof(double)));
+    int objno[] = {0, 0};
+    write_record(sol, objno, sizeof(objno));
+  } else {
+    sol << msg << "\nOptions\n";
+    for (int e : opt) sol << e << "\n";
+    sol << ng << "\n" << ng << "\n" << nx << "\n" << nx << "\n";
+    for (double e : lam) sol << e << "\n";
+    for (double e : x) sol << e << "\n";
+    sol << "objno 0 0\n";
+  }
+  return 0;
+}
+
+// Solve with the executable as the AMPL solver, twice to update the .nl file
+void test_round_trip(const std::string& solver, casadi_int nx, casadi_int ng,
+                     const std::string& nl_format) {
+  SX x = SX::sym("x", nx);
+  SX g = SX::zeros(0, 1);
+  for (casadi_int i=0; i<ng; ++i) g = vertcat(g, sin(x(i % nx)) * x(0));
+  Function solver_fcn = nlpsol("solver", "ampl", {{"x", x}, {"f", sumsqr(x)}, {"g", g}},
+                               {{"solver", solver}, {"nl_format", nl_format}});
+  for (double x0 : {0.5, 2.0}) {
+    DM x0_vec = DM::ones(nx, 1) * x0;
+    for (casadi_int i=0; i<nx; ++i) x0_vec(i) += 0.25*static_cast<double>(i);
+    DMDict res = solver_fcn(DMDict{{"x0", x0_vec}, {"lbx", -10}, {"ubx", 10},
+                                   {"lbg", -1}, {"ubg", 1}});
+    casadi_assert(static_cast<double>(norm_inf(res.at("x") - x0_vec - 1))==0,
+                  "Primal solution mismatch, " + nl_format + " format, nx=" + str(nx)
+                  + ", ng=" + str(ng) + ": " + str(res.at("x")));
+    for (casadi_int i=0; i<ng; ++i) {
+      casadi_assert(static_cast<double>(res.at("lam_g")(i))==-static_cast<double>(i+1),
+                    "Dual solution mismatch, " + nl_format + " format, nx=" + str(nx)
+                    + ", ng=" + str(ng) + ": " + str(res.at("lam_g")));
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc==3 && std::string(argv[1]).compare(0, 2, "-o")==0) {
+    return fake_solver(std::string(argv[1]).substr(2), argv[2]);
+  }
+  for (std::string nl_format : {"binary", "text"}) {
+    // A single variable: the primal solution has the length of the objective record
+    test_round_trip(argv[0], 1, 0, nl_format);
+    test_round_trip(argv[0], 1, 1, nl_format);
+    test_round_trip(argv[0], 3, 2, nl_format);
+  }
+  uout() << "AMPL tests passed" << std::endl;
+  return 0;
+}
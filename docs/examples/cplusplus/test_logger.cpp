@@ -0,0 +1,162 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/** \brief Tests of the asynchronous output of Logger
+
+    Ordering and completeness of blocking output, iteration records and
+    flushes, drop counting of a nonblocking buffer, and output with a sink
+    that needs a lock held by the caller. Requires thread support.
+*/
+
+#include <casadi/casadi.hpp>
+#include <casadi/config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace casadi;
+
+// Output received by the sinks
+std::string received;
+casadi_int n_flush = 0;
+std::vector<Logger::Iteration> records;
+
+// Sink is slowed down while set
+std::atomic<bool> hold(false);
+
+// Lock needed by the sink, like the Python GIL
+std::mutex sink_lock;
+
+void test_write(const char* s, std::streamsize num, bool error) {
+  std::lock_guard<std::mutex> lock(sink_lock);
+  while (hold) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  received.append(s, num);
+}
+
+void test_flush(bool error) {
+  n_flush++;
+}
+
+void test_iteration(const Logger::Iteration& r) {
+  records.push_back(r);
+}
+
+// Number of lines in a string
+casadi_int n_lines(const std::string& s) {
+  return std::count(s.begin(), s.end(), '\n');
+}
+
+void reset() {
+  received.clear();
+  n_flush = 0;
+  records.clear();
+}
+
+int main() {
+#ifdef CASADI_WITH_THREAD
+  auto write_orig = Logger::writeFun;
+  auto flush_orig = Logger::flush;
+  Logger::writeFun = test_write;
+  Logger::flush = test_flush;
+  Logger::iterationFun = test_iteration;
+
+  // Blocking buffer, smaller than the output: nothing is lost or reordered
+  reset();
+  Logger::start_async(4, true);
+  casadi_assert(Logger::is_async(), "Not asynchronous");
+  std::stringstream expected;
+  for (casadi_int k=0; k<100; ++k) {
+    uout() << "line " << k << std::endl;
+    expected << "line " << k << std::endl;
+    Logger::iteration("test", k, k, 0.1, 0.2);
+  }
+  uout() << "unterminated";
+  expected << "unterminated";
+  Logger::stop_async();
+  casadi_assert(!Logger::is_async(), "Still asynchronous");
+  casadi_assert(received==expected.str(), "Output lost or reordered");
+  casadi_assert(Logger::n_dropped()==0, "Entries dropped");
+  casadi_assert(n_flush==100, "Expected 100 flushes, got " + str(n_flush));
+  casadi_assert(records.size()==100, "Iteration records lost");
+  for (casadi_int k=0; k<100; ++k) {
+    casadi_assert(records[k].iter==k && records[k].pr_inf==0.1, "Iteration record mismatch");
+  }
+
+  // Nonblocking buffer with a stalled sink: entries are dropped and counted
+  reset();
+  hold = true;
+  Logger::start_async(4, false);
+  for (casadi_int k=0; k<100; ++k) uout() << "line " << k << "\n";
+  hold = false;
+  Logger::stop_async();
+  casadi_assert(Logger::n_dropped()>0, "No entries dropped");
+  casadi_assert(n_lines(received) + Logger::n_dropped()==100,
+    "Lines received (" + str(n_lines(received)) + ") and dropped ("
+    + str(Logger::n_dropped()) + ") do not add up");
+
+  // Restarting resets the count
+  Logger::start_async(4, false);
+  casadi_assert(Logger::n_dropped()==0, "Drop count not reset");
+  Logger::stop_async();
+
+  // Sink needing a lock held by the caller: a blocking buffer would deadlock
+  reset();
+  Logger::writeFunLocks = true;
+  Logger::start_async(4, true);
+  {
+    std::lock_guard<std::mutex> lock(sink_lock);
+    for (casadi_int k=0; k<100; ++k) uout() << "line " << k << "\n";
+  }
+  Logger::stop_async();
+  Logger::writeFunLocks = false;
+  casadi_assert(Logger::n_dropped()>0, "No entries dropped");
+  casadi_assert(n_lines(received) + Logger::n_dropped()==100, "Lines lost");
+
+  // Synchronous output is unaffected
+  reset();
+  uout() << "sync" << std::endl;
+  Logger::iteration("test", 0, 1, 2, 3);
+  casadi_assert(received=="sync\n" && n_flush==1 && records.size()==1, "Synchronous output");
+
+  Logger::writeFun = write_orig;
+  Logger::flush = flush_orig;
+  Logger::iterationFun = nullptr;
+  uout() << "Logger tests passed" << std::endl;
+#else // CASADI_WITH_THREAD
+  // Asynchronous output needs thread support
+  bool failed = false;
+  try {
+    Logger::start_async();
+  } catch (std::exception& e) {
+    failed = true;
+  }
+  casadi_assert(failed, "start_async should fail without thread support");
+  uout() << "Logger tests skipped, no thread support" << std::endl;
+#endif // CASADI_WITH_THREAD
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/** \brief Concurrent derivative generation
+
+    Several threads request the Jacobian, forward and reverse derivatives,
+    Jacobian sparsity and factory functions of the same SX and MX functions.
+    All threads must obtain the same cached functions, with correct values.
+    Requires thread support.
+*/
+
+#include <casadi/casadi.hpp>
+#include <casadi/config.h>
+
+#ifdef CASADI_WITH_THREAD
+#include <atomic>
+#include <thread>
+#endif // CASADI_WITH_THREAD
+
+using namespace casadi;
+
+// Test function with some coupling between the elements
+template<typename M>
+Function test_function(const std::string& name) {
+  M x = M::sym("x", 5), p = M::sym("p", 2);
+  M y = sin(x)*p(0) + vertcat(x(Slice(1, 5)), x(0))*p(1);
+  return Function(name, {x, p}, {y, dot(y, y)}, {"x", "p"}, {"y", "f"});
+}
+
+#ifdef CASADI_WITH_THREAD
+// Derivative functions requested by one thread
+struct Derivatives {
+  Function jac, fwd, adj, fac;
+  Sparsity sp;
+};
+
+Derivatives generate(const Function& f) {
+  Derivatives d;
+  d.sp = f.sparsity_jac("x", "y");
+  d.fwd = f.forward(2);
+  d.adj = f.reverse(1);
+  d.jac = f.jacobian();
+  d.fac = f.factory("fac", {"x", "p"}, {"jac:f:x", "hess:f:x:x"});
+  return d;
+}
+
+template<typename M>
+void test_concurrent(casadi_int n_thread, casadi_int n_rep) {
+  for (casadi_int rep=0; rep<n_rep; ++rep) {
+    // Fresh function, so that nothing is in the cache
+    Function g = test_function<M>("f");
+    std::vector<Derivatives> d(n_thread);
+    std::vector<std::string> err(n_thread);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (casadi_int k=0; k<n_thread; ++k) {
+      threads.emplace_back([&, k]() {
+        while (!go) std::this_thread::yield();
+        try {
+          d[k] = generate(g);
+        } catch (std::exception& e) {
+          err[k] = e.what();
+        }
+      });
+    }
+    go = true;
+    for (auto&& t : threads) t.join();
+    for (casadi_int k=0; k<n_thread; ++k) {
+      casadi_assert(err[k].empty(), "Thread " + str(k) + " failed: " + err[k]);
+      // Cached functions are shared
+      casadi_assert(d[k].jac.get()==d[0].jac.get(), "Jacobian generated twice");
+      casadi_assert(d[k].fwd.get()==d[0].fwd.get(), "Forward derivative generated twice");
+      casadi_assert(d[k].adj.get()==d[0].adj.get(), "Reverse derivative generated twice");
+      casadi_assert(d[k].sp==d[0].sp, "Jacobian sparsity mismatch");
+    }
+    // Values, against the original function
+    DM x = DM(std::vector<double>{0.1, 0.2, 0.3, 0.4, 0.5}), p = DM(std::vector<double>{2, 3});
+    DM J_ref = g.factory("jac_ref", {"x", "p"}, {"jac:y:x"})(std::vector<DM>{x, p}).at(0);
+    for (casadi_int k=0; k<n_thread; ++k) {
+      DM J = d[k].jac(std::vector<DM>{x, p, DM(), DM()}).at(0);
+      casadi_assert(static_cast<double>(norm_inf(J(Slice(0, 5), Slice(0, 5)) - J_ref))<1e-12,
+        "Jacobian mismatch");
+      casadi_assert(J_ref.sparsity().unite(d[k].sp)==d[k].sp, "Jacobian sparsity mismatch");
+      DM H = d[k].fac(std::vector<DM>{x, p}).at(1);
+      casadi_assert(H.size1()==5 && H.size2()==5, "Hessian dimension mismatch");
+    }
+  }
+}
+#endif // CASADI_WITH_THREAD
+
+int main() {
+#ifdef CASADI_WITH_THREAD
+  casadi_int n_thread = 8;
+  test_concurrent<SX>(n_thread, 20);
+  test_concurrent<MX>(n_thread, 20);
+  uout() << "Thread tests passed" << std::endl;
+#else // CASADI_WITH_THREAD
+  uout() << "Thread tests skipped, no thread support" << std::endl;
+#endif // CASADI_WITH_THREAD
+  return 0;
+}
@@ -49,16 +49,22 @@
 %{
   namespace casadi {
     // Redirect printout
+    // Note: may be called with the GIL released, cf. FunctionBuffer
     static void pythonlogger(const char* s, std::streamsize num, bool error) {
+      PyGILState_STATE gstate = PyGILState_Ensure();
       if (error) {
         PySys_WriteStderr("%.*s", static_cast<int>(num), s);
       } else {
         PySys_WriteStdout("%.*s", static_cast<int>(num), s);
       }
+      PyGILState_Release(gstate);
     }
 
     static bool pythoncheckinterrupted() {
-      return PyErr_CheckSignals();
+      PyGILState_STATE gstate = PyGILState_Ensure();
+      bool ret = PyErr_CheckSignals();
+      PyGILState_Release(gstate);
+      return ret;
     }
 
     void handle_director_exception() {
@@ -87,6 +93,8 @@
 %init %{
   // Set logger functions
   casadi::Logger::writeFun = casadi::pythonlogger;
+  // pythonlogger acquires the GIL
+  casadi::Logger::writeFunLocks = true;
 
   // @jgillis: please document
   casadi::InterruptHandler::checkInterrupted = casadi::pythoncheckinterrupted;
@@ -3843,11 +3851,122 @@ def PyFunction(name, obj, inputs, outputs, opts={}):
 %}
 #endif
 
+#ifdef SWIGPYTHON
+// Zero-copy access to objects implementing the buffer protocol, e.g. NumPy arrays.
+// Data must be doubles in column-major order (Fortran contiguous), the size is in bytes.
+// The typemaps only pass the pointer on: FunctionBuffer.set_arg and set_res keep a
+// memoryview of the object, which holds an export of its memory while set
+%rename(_set_arg) casadi::FunctionBuffer::set_arg;
+%rename(_set_res) casadi::FunctionBuffer::set_res;
+%typemap(in, doc="buffer", noblock=1) (const double* a, casadi_int size) (Py_buffer buf) {
+  if (PyObject_GetBuffer($input, &buf, PyBUF_F_CONTIGUOUS | PyBUF_FORMAT)) {
+    SWIG_exception_fail(SWIG_TypeError, "Expected a Fortran contiguous buffer of doubles");
+  }
+  if (buf.itemsize!=sizeof(double) || !buf.format || buf.format[strlen(buf.format)-1]!='d') {
+    PyBuffer_Release(&buf);
+    SWIG_exception_fail(SWIG_TypeError, "Expected a Fortran contiguous buffer of doubles");
+  }
+  $1 = static_cast<const double*>(buf.buf);
+  $2 = buf.len;
+  PyBuffer_Release(&buf);
+}
+%typemap(typecheck, noblock=1, precedence=SWIG_TYPECHECK_POINTER) (const double* a, casadi_int size) {
+  $1 = PyObject_CheckBuffer($input);
+}
+%typemap(in, doc="buffer", noblock=1) (double* a, casadi_int size) (Py_buffer buf) {
+  if (PyObject_GetBuffer($input, &buf, PyBUF_F_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE)) {
+    SWIG_exception_fail(SWIG_TypeError, "Expected a writable Fortran contiguous buffer of doubles");
+  }
+  if (buf.itemsize!=sizeof(double) || !buf.format || buf.format[strlen(buf.format)-1]!='d') {
+    PyBuffer_Release(&buf);
+    SWIG_exception_fail(SWIG_TypeError, "Expected a writable Fortran contiguous buffer of doubles");
+  }
+  $1 = static_cast<double*>(buf.buf);
+  $2 = buf.len;
+  PyBuffer_Release(&buf);
+}
+%typemap(typecheck, noblock=1, precedence=SWIG_TYPECHECK_POINTER) (double* a, casadi_int size) {
+  $1 = PyObject_CheckBuffer($input);
+}
+
+// Release the GIL during buffer evaluations, reacquire it before raising
+%define BUFFER_EVAL_EXCEPTION
+{
+  std::string msg;
+  bool failed = false;
+  Py_BEGIN_ALLOW_THREADS
+  try {
+    $action
+  } catch(const std::exception& e) {
+    failed = true;
+    msg = e.what();
+  }
+  Py_END_ALLOW_THREADS
+  if (failed) SWIG_exception(SWIG_RuntimeError, msg.c_str());
+}
+%enddef
+%exception casadi::FunctionBuffer::_eval BUFFER_EVAL_EXCEPTION
+%exception casadi::_function_buffer_eval BUFFER_EVAL_EXCEPTION
+#endif // SWIGPYTHON
+
 %include <casadi/core/function.hpp>
 #ifdef SWIGPYTHON
 namespace casadi{
+%extend FunctionBuffer {
+  %pythoncode %{
+    def set_arg(self, i, a):
+      """
+      Set input buffer for input i
+
+      a must hold the nonzeros as doubles in column-major order. It is not
+      copied and cannot be resized while set.
+      """
+      # The view holds an export: the memory cannot be reallocated while set
+      v = memoryview(a)
+      self._set_arg(i, v)
+      self.__dict__.setdefault("_views", {})[("arg", i)] = v
+
+    def set_res(self, i, a):
+      """
+      Set output buffer for output i
+
+      a must be writable and hold the nonzeros as doubles in column-major
+      order. It is not copied and cannot be resized while set.
+      """
+      v = memoryview(a)
+      self._set_res(i, v)
+      self.__dict__.setdefault("_views", {})[("res", i)] = v
+  %}
+}
 %extend Function {
   %pythoncode %{
+    def buffer(self):
+      """
+      Create a FunctionBuffer object for evaluating with minimal overhead
+
+      Returns a tuple (buffer, caller). Inputs and outputs are set with
+      buffer.set_arg(i, a) and buffer.set_res(i, a), where a is e.g. a NumPy
+      array with the nonzeros in column-major order. No copies are made: the
+      arrays are kept alive, and cannot be resized, while set. Calling caller() evaluates the
+      function, with the GIL released; buffer.ret() gives the return value.
+
+      Functions embedding a Python Callback must not be evaluated this way.
+
+      Example:
+        x = np.zeros(f.nnz_in(0))
+        y = np.zeros(f.nnz_out(0))
+        fb, f_eval = f.buffer()
+        fb.set_arg(0, x)
+        fb.set_res(0, y)
+        f_eval()
+      """
+      import functools
+      fb = FunctionBuffer(self)
+      caller = functools.partial(_casadi._function_buffer_eval, fb._self())
+      # The partial only holds a raw pointer, keep the buffer alive with it
+      caller.buffer = fb
+      return (fb, caller)
+
     def __call__(self, *args, **kwargs):
       # Either named inputs or ordered inputs
       if len(args)>0 and len(kwargs)>0:
@@ -4170,6 +4289,7 @@ namespace casadi {
 %include <casadi/core/importer.hpp>
 %include <casadi/core/callback.hpp>
 %include <casadi/core/global_options.hpp>
+%include <casadi/core/perf_counters.hpp>
 %include <casadi/core/casadi_meta.hpp>
 %include <casadi/core/integration_tools.hpp>
 %include <casadi/core/nlp_builder.hpp>
@@ -897,6 +897,93 @@ class ConicTests(casadiTestCase):
     self.checkarray(sol_ref["lam_x"], sol["lam_x"],digits=8)
 
 
+  @requires_conic("qpoases")
+  def test_qpoases_hotstart(self):
+    H = DM([[2,-1],[-1,2]])
+    A = DM([[1,1]])
+    for options in [{}, {"sparse": True}, {"fixed_matrices": True}, {"check_matrices": False}]:
+      for a in [A, DM.zeros(0,2)]:
+        solver = conic('solver', 'qpoases', {"a": a.sparsity(), "h": H.sparsity()}, options)
+        for k, g in enumerate([DM([-2,-6]), DM([1,-3]), DM([-4,0])]):
+          ref = conic('solver', 'qpoases', {"a": a.sparsity(), "h": H.sparsity()})
+          args = dict(h=H,a=a,g=g,lbx=-2,ubx=1)
+          if a.size1()>0: args.update(lba=-1,uba=1)
+          sol = solver(**args)
+          sol_ref = ref(**args)
+          self.checkarray(sol["x"], sol_ref["x"], str(options))
+          self.checkarray(sol["lam_x"], sol_ref["lam_x"], str(options))
+          self.checkarray(sol["cost"], sol_ref["cost"], str(options))
+          # Vector-only hotstart after the first call, unless H and A are not checked
+          self.assertEqual(solver.stats()["vector_hotstart"],
+                           k>0 and "check_matrices" not in options, str(options))
+        # Changed Hessian must not be missed unless declared fixed
+        if "fixed_matrices" not in options:
+          sol = solver(**dict(args, h=2*H))
+          sol_ref = ref(**dict(args, h=2*H))
+          self.checkarray(sol["x"], sol_ref["x"], str(options))
+          self.assertFalse(solver.stats()["vector_hotstart"])
+
+  @requires_conic("condensing")
+  @requires_conic("qrqp")
+  def test_condensing(self):
+    N = 4
+    Ad = DM([[1,0.1],[-0.2,0.9]])
+    Bd = DM([[0],[0.1]])
+    X = [SX.sym("x%d" % k,2) for k in range(N+1)]
+    U = [SX.sym("u%d" % k) for k in range(N)]
+    w = []
+    g = []
+    lbg = []
+    ubg = []
+    f = 0
+    for k in range(N):
+      w += [X[k],U[k]]
+      g += [mtimes(Ad,X[k])+mtimes(Bd,U[k])-X[k+1], X[k][0]+U[k]]
+      lbg += [DM.zeros(2), -1.5]
+      ubg += [DM.zeros(2), 1.5]
+      f += sumsqr(X[k]) + 0.1*sumsqr(U[k]) + dot(X[k],DM([1,0.5]))
+    w.append(X[N])
+    g.append(X[N][1])
+    lbg.append(-0.5)
+    ubg.append(0.5)
+    f += 10*sumsqr(X[N])
+    w = vertcat(*w)
+    qp = {"x": w, "f": f, "g": vertcat(*g)}
+    lbx = vertcat(*([0.9,0.4,-1]+[-inf,-inf,-1]*(N-1)+[-inf,-0.2]))
+    ubx = vertcat(*([1,0.5,1]+[inf,inf,1]*(N-1)+[inf,inf]))
+    args = dict(lbx=lbx,ubx=ubx,lbg=vertcat(*lbg),ubg=vertcat(*ubg))
+
+    ref = qpsol("ref", "qrqp", qp, {"print_iter": False})
+    sol_ref = ref(**args)
+    for options in [{}, {"N":N,"nx":[2]*(N+1),"nu":[1]*N,"ng":[1]*(N+1)}]:
+      solver = qpsol("solver", "condensing", qp, options)
+      for i in range(2):
+        sol = solver(**args)
+        for k in ["x","f","lam_x","lam_g"]:
+          self.checkarray(sol[k], sol_ref[k], str(options)+k, digits=7)
+      # Changed bounds reuse the condensing matrices
+      args2 = dict(args,ubg=args["ubg"]*1.2)
+      sol = solver(**args2)
+      sol_ref2 = ref(**args2)
+      for k in ["x","f","lam_x","lam_g"]:
+        self.checkarray(sol[k], sol_ref2[k], str(options)+k, digits=7)
+
+  @requires_conic("condensing")
+  @requires_conic("qrqp")
+  def test_condensing_detect(self):
+    x = SX.sym("x",3)
+    f = sumsqr(x-DM([1,2,3]))
+    # No constraints: a single stage
+    solver = qpsol("solver", "condensing", {"x": x, "f": f})
+    self.checkarray(solver()["x"], DM([1,2,3]), digits=7)
+    # A dense 1x2 constraint matrix is a single gap constraint x1 = -x0
+    y = SX.sym("y",2)
+    solver = qpsol("solver", "condensing", {"x": y, "f": sumsqr(y-DM([1,2])), "g": y[0]+y[1]})
+    self.checkarray(solver(lbg=0,ubg=0)["x"], DM([-0.5,0.5]), digits=7)
+    # Not OCP-structured
+    with self.assertInException("Cannot detect an OCP structure"):
+      qpsol("solver", "condensing", {"x": x, "f": f, "g": x[0]+x[1]})
+
   def test_SOCP(self):
     x = MX.sym("x")
     y = MX.sym("y")
@@ -870,6 +870,151 @@ class Functiontests(casadiTestCase):
   #   [v] = f([])
   #   self.checkarray(2.37683, v, digits=4)
 
+  @requiresPlugin(Importer,"shell")
+  def test_jit_pgo(self):
+    x = SX.sym("x", 3)
+    y = x
+    for i in range(5):
+      y = if_else(y>0.5, sin(y)*y, cos(y)+0.1*y)
+    inputs = [[0.1*k]*3 for k in range(10)]
+    F = Function("F", [x], [y], {"jit": True, "compiler": "shell", "jit_pgo_inputs": inputs})
+    Fref = Function("F", [x], [y])
+    self.checkfunction(F, Fref, inputs=[DM([0.3,0.7,1.1])], sens_der=False, evals=False)
+    self.assertTrue(F.stats()["jit_pgo_speedup"]>0)
+    # Solvers report it next to their own statistics
+    p = SX.sym("p")
+    g = Function("g", [x, p], [x**3+x-p])
+    rf = rootfinder("rf", "newton", g, {"linear_solver": "qr", "jit": True, "compiler": "shell",
+                                        "jit_pgo_inputs": [[0, 0, 0, 0.5*k] for k in range(5)]})
+    self.checkarray(rf(0, 2), DM.ones(3))
+    stats = rf.stats()
+    self.assertTrue(stats["jit_pgo_speedup"]>0)
+    self.assertTrue("iter_count" in stats)
+
+  def test_buffer(self):
+    x = MX.sym("x", 3)
+    A = MX.sym("A", Sparsity.lower(3))
+    f = Function("f", [x, A], [sin(x)*2, mtimes(A, x)])
+
+    xv = numpy.array([1.0, 2.0, 3.0])
+    Av = numpy.array([1.0, 2.0, 3.0, 4.0, 5.0, 6.0]) # nonzeros
+    y0 = numpy.zeros(3)
+    y1 = numpy.zeros(3)
+
+    fb, f_eval = f.buffer()
+    fb.set_arg(0, xv)
+    fb.set_arg(1, Av)
+    fb.set_res(0, y0)
+    fb.set_res(1, y1)
+    f_eval()
+    self.assertEqual(fb.ret(), 0)
+    r = f(xv, DM(Sparsity.lower(3), Av))
+    self.checkarray(y0, r[0])
+    self.checkarray(y1, r[1])
+
+    # Inputs are not copied
+    xv[:] = [4.0, 5.0, 6.0]
+    f_eval()
+    r = f(xv, DM(Sparsity.lower(3), Av))
+    self.checkarray(y0, r[0])
+
+    # Sizes and memory layout are checked
+    with self.assertRaises(Exception):
+      fb.set_arg(0, numpy.zeros(4))
+    with self.assertRaises(Exception):
+      fb.set_res(0, numpy.zeros(3, dtype=numpy.int32))
+    with self.assertRaises(Exception):
+      fb.set_arg(1, numpy.zeros((2, 3)))
+    with self.assertRaises(Exception):
+      fb.set_res(0, xv[::2])
+
+    # Objects are kept alive and cannot be resized while set
+    fb.set_arg(0, numpy.array([4.0, 5.0, 6.0]))
+    import gc
+    gc.collect()
+    f_eval()
+    self.checkarray(y0, 2*sin(DM([4.0, 5.0, 6.0])))
+    b = bytearray(xv.tobytes())
+    fb.set_arg(0, memoryview(b).cast('d'))
+    with self.assertRaises(BufferError):
+      b.extend(bytes(80))
+    fb.set_arg(0, xv)
+    b.extend(bytes(80))
+
+    # The caller keeps the buffer alive
+    _, f_eval = f.buffer()
+    gc.collect()
+    f_eval()
+    self.assertEqual(f_eval.buffer.ret(), 0)
+
+    # Evaluation with the GIL released, one buffer per thread
+    import threading
+    X = [numpy.random.random(3) for i in range(4)]
+    Y = [numpy.zeros(3) for i in range(4)]
+    def work(k):
+      fb, f_eval = f.buffer()
+      fb.set_arg(0, X[k])
+      fb.set_arg(1, Av)
+      fb.set_res(0, Y[k])
+      for i in range(100): f_eval()
+    threads = [threading.Thread(target=work, args=(k,)) for k in range(4)]
+    for t in threads: t.start()
+    for t in threads: t.join()
+    for k in range(4):
+      self.checkarray(Y[k], numpy.sin(X[k])*2)
+
+  def test_perf_counters(self):
+    x = MX.sym("x", 2)
+    f = Function("f", [x], [sin(x[0])*x[1]])
+
+    PerfCounters.reset()
+    f.jacobian()
+    self.assertEqual(PerfCounters.count("cache_miss"), 0)
+
+    PerfCounters.enable()
+    try:
+      f = Function("f", [x], [sin(x[0])*x[1]])
+      # The cache holds weak references, keep the Jacobian alive for a hit
+      J = f.jacobian()
+      f.jacobian()
+      s = PerfCounters.stats()
+      self.assertEqual(s["cache_miss"]["count"], 1)
+      self.assertEqual(s["cache_hit"]["count"], 1)
+      self.assertTrue(s["function_construct"]["count"]>=2)
+      self.assertTrue(s["function_construct"]["time"]>0)
+      self.assertTrue("time" not in s["cache_hit"])
+      with self.assertRaises(Exception):
+        PerfCounters.count("no_such_event")
+    finally:
+      PerfCounters.enable(False)
+    PerfCounters.reset()
+    self.assertEqual(PerfCounters.count("cache_hit"), 0)
+
+  def test_memory_footprint(self):
+    x = SX.sym("x", 3)
+    f = Function("f", [x], [sin(x)*x[0]+3.5])
+    fp = f.memory_footprint()
+    self.assertEqual(fp["class"], "SXFunction")
+    self.assertTrue(fp["algorithm"]>0)
+    self.assertTrue(fp["nodes"]["count"]>0)
+    self.assertEqual(fp["total"], sum(v["total"] if isinstance(v, dict) else v
+      for k, v in fp.items() if k not in ["class", "n_mem", "total"]))
+
+    # Cached derivatives are included while alive
+    J = f.jacobian()
+    fp2 = f.memory_footprint()
+    self.assertTrue(J.name() in fp2["cache"])
+    self.assertTrue(fp2["total"]>fp["total"])
+
+    # Linear solver factors
+    y = MX.sym("y", 3)
+    g = Function("g", [y], [mtimes(DM.rand(3, 3)+3*DM.eye(3), y) + f(y)])
+    r = rootfinder("r", "newton", g, {"linear_solver": "qr"})
+    r(DM.ones(3))
+    fp = r.memory_footprint()
+    self.assertTrue(fp["linsol"]["memory"]>0)
+    self.assertEqual(fp["oracle"]["class"], "MXFunction")
+
   def test_depends_on(self):
     x = SX.sym("x")
     y = x**2
@@ -991,6 +1136,42 @@ class Functiontests(casadiTestCase):
       self.checkarray(J(a).T, r)
       self.check_codegen(J,inputs=[a])
 
+  def test_interpolant_value_jacobian(self):
+    grid = [[0, 1, 4, 5],
+            [0, 2, 3]]
+    values = [0,   1,  8,  3,
+              10, -11, 12, 13,
+              20, 31, -42, 53]
+    X = MX.sym("x",2)
+    for plugin in ["linear", "bspline"]:
+      F = interpolant('F', plugin, grid, values)
+
+      # Value and Jacobian evaluated by a single call
+      G = Function("G",[X],[F(X), jacobian(F(X),X)])
+      calls = [G.instruction_MX(k).which_function().name() for k in range(G.n_instructions()) if G.instruction_MX(k).is_call()]
+      self.assertEqual(calls, ["val_jac_F"])
+
+      # Opt-out
+      G0 = Function("G0",[X],[F(X), jacobian(F(X),X)],{"fuse_value_jacobian":False})
+      calls = [G0.instruction_MX(k).which_function().name() for k in range(G0.n_instructions()) if G0.instruction_MX(k).is_call()]
+      self.assertTrue("val_jac_F" not in calls)
+
+      # Functions generated by a solver
+      if has_nlpsol("sqpmethod") and has_conic("qrqp"):
+        solver = nlpsol("solver","sqpmethod",{"x":X,"f":sumsqr(X),"g":F(X)},
+          {"qpsol":"qrqp","hessian_approximation":"limited-memory"})
+        J = solver.get_function("nlp_jac_fg")
+        calls = [J.instruction_MX(k).which_function().name() for k in range(J.n_instructions()) if J.instruction_MX(k).is_call()]
+        self.assertEqual(calls, ["val_jac_F"])
+
+      H = Function("H",[X],[jacobian(G(X)[1],X)])
+      Href = Function("Href",[X],[jacobian(F.jacobian()(X, 0),X)])
+      for a in [vertcat(1,2), vertcat(3,2.4), vertcat(4.5,0.3), vertcat(-1,4)]:
+        self.checkarray(G(a)[0], F(a))
+        self.checkarray(G(a)[1], F.jacobian()(a, 0))
+        self.checkarray(H(a), Href(a))
+        self.check_codegen(G,inputs=[a])
+
   def test_1d_interpolant_uniform(self):
     grid = [[0, 1, 2]]
     values = [0, 1, 2]
@@ -1793,6 +1974,163 @@ class Functiontests(casadiTestCase):
       r_mx = F(DM([[1,2,3]]))
       self.checkarray(r_all, r_mx, "Mapped evaluation (MX)")
 
+  def test_inline_threshold(self):
+      a = SX.sym("a")
+      b = SX.sym("b", 2)
+      f = Function("f", [a, b], [a*b+sin(b), dot(b,b)])
+      c = MX.sym("c", 2)
+      g = Function("g", [c], [c/(1+sumsqr(c))])
+      big = Function("big", [c], [repmat(c,5)]).expand()
+
+      x = MX.sym("x")
+      y = MX.sym("y", 2)
+      A = MX.sym("A", 2, 2)
+      xx, yy = x, y
+      for i in range(10):
+        r = f(xx, yy)
+        yy = g(mtimes(A, 0.5*r[0]+0.1))
+        xx = 0.1*r[1]+sum1(big(yy))
+
+      inputs = [0.3, DM([0.1,0.2]), DM([[1,0.2],[0.3,0.9]])]
+      Fref = Function("F", [x, y, A], [yy, xx])
+      for thr in [0, 10, 100]:
+        F = Function("F", [x, y, A], [yy, xx], {"inline_threshold": thr})
+        self.checkfunction(F, Fref, inputs=inputs)
+      self.assertTrue(F.n_instructions()<Fref.n_instructions())
+      self.check_codegen(F, inputs=inputs)
+
+  def test_output_pruning(self):
+      x = SX.sym("x", 3)
+      y = SX.sym("y")
+      s = sin(x)*y
+      fsx = Function("fsx", [x, y], [s*s, cos(s)+x[0], exp(y)*x[2]])
+      X = MX.sym("X", 3)
+      Y = MX.sym("Y")
+      r = fsx(X, Y)
+      sp = vertsplit(r[0], [0, 1, 3])
+      fmx = Function("fmx", [X, Y], [sp[0]+r[2], 2*sp[1], r[1]])
+      inputs = [DM([0.1,0.2,0.3]), 0.7]
+      # Calls with some of the outputs unused evaluate only part of the algorithm
+      for f in [fsx, fmx]:
+        ref = f(*inputs)
+        for i in range(f.n_out()):
+          g = Function("g", [X, Y], [f(X, Y)[i]])
+          self.checkarray(g(*inputs), ref[i], "output %d" % i)
+
+  def test_incremental(self):
+      x = SX.sym("x", 3)
+      p = SX.sym("p", 2)
+      lam = SX.sym("lam")
+      L = sumsqr(sin(x)*p[0]) + lam*dot(x, exp(p[1]*x))
+      sx_out = [L, hessian(L, x)[0]]
+      X = MX.sym("X", 3)
+      P = MX.sym("P", 2)
+      Lam = MX.sym("Lam")
+      r = Function("fsx", [x, p, lam], sx_out)(X, P, Lam)
+      mx_out = [r[0]*P[1], mtimes(r[1], X)+1]
+      # Inputs changing one at a time, repeated and missing
+      inputs = [[DM([1,2,3]), DM([0.5,0.1]), 2], [DM([1,2,3]), DM([0.5,0.1]), 3],
+                [DM([1,2,4]), DM([0.5,0.1]), 3], [DM([1,2,4]), DM([0.6,0.1]), 3],
+                [DM([1,2,4]), DM([0.6,0.1]), 3], [DM([1,2,4]), 0, 3]]
+      for args, out in [([x, p, lam], sx_out), ([X, P, Lam], mx_out)]:
+        f = Function("f", args, out)
+        F = Function("F", args, out, {"incremental": True})
+        for i in inputs:
+          for ref, res in zip(f(*i), F(*i)):
+            self.checkarray(ref, res)
+        # Only the instructions depending on changed inputs are executed
+        F = Function("F", args, out, {"incremental": True})
+        n_all = F.n_instructions()
+        n_out = len([k for k in range(n_all) if F.instruction_id(k)==OP_OUTPUT])
+        F(*inputs[0])
+        self.assertEqual(F.stats()["n_exec"], n_all)
+        F(*inputs[1])
+        self.assertTrue(n_out<F.stats()["n_exec"]<n_all)
+        F(*inputs[1])
+        self.assertEqual(F.stats()["n_exec"], n_out)
+
+  def test_specialize(self):
+      x = SX.sym("x", 3)
+      p = SX.sym("p", 2)
+      T = SX.sym("T", 3, 3)
+      fsx = Function("fsx", [x, p, T], [mtimes(T*p[0], sin(x))+exp(p[1])*x, sqrt(p[0]*p[1])],
+                     ["x", "p", "T"], ["f", "g"])
+      X = MX.sym("x", 3)
+      P = MX.sym("p", 2)
+      TT = MX.sym("T", 3, 3)
+      A = mtimes(TT, TT)*P[0] + DM.eye(3)
+      fmx = Function("fmx", [X, P, TT], [solve(A, sin(X))+fsx(X, P, TT)[0], norm_fro(A)],
+                     ["x", "p", "T"], ["f", "g"])
+      pv = DM([2, 3])
+      Tv = DM([[0.5, 1, 0], [0, 0.5, 0], [0, 0, 0.5]])
+      xv = DM([0.1, 0.2, 0.3])
+      for f in [fsx, fmx]:
+        fs = f.specialize("fs", {"p": pv, "T": Tv})
+        self.assertEqual(fs.name_in(), ["x"])
+        self.assertTrue(fs.n_instructions()<f.n_instructions())
+        self.checkfunction_light(fs, Function("ref", [X], f(X, pv, Tv), ["x"], ["f", "g"]),
+                                 inputs=[xv])
+        J = Function("J", [X], [jacobian(fs(X)[0], X)])
+        Jref = Function("Jref", [X], [jacobian(f(X, pv, Tv)[0], X)])
+        self.checkarray(J(xv), Jref(xv))
+        self.check_codegen(fs, inputs=[xv])
+        fp = f.specialize("fp", {"p": pv})
+        self.checkarray(fp(xv, Tv)[0], f(xv, pv, Tv)[0])
+      with self.assertInException("Dimension mismatch"):
+        fsx.specialize("fs", {"p": DM.zeros(3)})
+      # Functions that cannot be inlined are called
+      F = interpolant("F", "linear", [[0, 1, 2, 3], [0, 1, 2]], [0.5*i**2 for i in range(12)])
+      a = MX.sym("a")
+      b = MX.sym("b")
+      H = Function("G", [a, b], [F(vertcat(a, b))]).map(2)
+      self.assertEqual(H.class_name(), "Map")
+      Hs = H.specialize("Hs", {"i1": DM([[0.5, 1.5]])})
+      self.checkarray(Hs(DM([[1.5, 2.5]])), H(DM([[1.5, 2.5]]), DM([[0.5, 1.5]])))
+      Fs = F.specialize("Fs", {"x": DM([1.5, 0.5])})
+      self.assertEqual(Fs.n_in(), 0)
+      self.checkarray(Fs()["f"], F([1.5, 0.5]))
+
+  def test_fold_constants(self):
+      x = MX.sym("x", 3)
+      C = MX(DM([[1, 2, 0], [0, 1, 3], [4, 0, 1]]))
+      s = MX(DM([2, 0.5, 1]))
+      A = mtimes(C, C.T)*3.6 + diag(exp(s))
+      Ainv = inv(A)
+      sf = MX.sym("s", 3)
+      fsx = Function("fsx", [x, sf], [sin(x)*sf])
+      r = [mtimes(Ainv, x) + fsx(x, 2*s), dot(s, s)*norm_fro(A)]
+      f = Function("f", [x], r)
+      ff = Function("ff", [x], r, {"fold_constants": True})
+      self.assertTrue(ff.n_instructions()<f.n_instructions())
+      self.assertTrue(ff.sz_w()<=f.sz_w())
+      self.checkfunction_light(ff, f, inputs=[DM([0.1, 0.2, 0.3])])
+      self.check_codegen(ff, inputs=[DM([0.1, 0.2, 0.3])])
+
+  def test_reorder_mtimes(self):
+      A = MX.sym("A", 6, 6)
+      B = MX.sym("B", Sparsity.banded(6, 1))
+      C = MX.sym("C", 6, 6)
+      x = MX.sym("x", 6)
+      AB = mtimes(A, B)
+      f = Function("f", [A, B, C, x], [mtimes(mtimes(AB, C), x), mtimes(AB, x)])
+      fr = Function("fr", [A, B, C, x], f(A, B, C, x), {"reorder_mtimes": True})
+      fv = Function("fv", [A, B, C, x], [mtimes([A, B, C, x]), mtimes(AB, x)])
+      inputs = [DM.rand(6, 6), DM.rand(Sparsity.banded(6, 1)), DM.rand(6, 6), DM.rand(6, 1)]
+      # Multiplications in the matrix products: nnz(x(:,k))*nnz(y(k,:)) summed over k
+      def n_mult(F):
+        n = 0
+        for k in range(F.n_instructions()):
+          if F.instruction_id(k)==OP_MTIMES:
+            e = F.instruction_MX(k)
+            n += float(mtimes(sum1(DM(e.dep(1).sparsity(), 1)), sum2(DM(e.dep(2).sparsity(), 1))))
+        return n
+      self.assertEqual(n_mult(f), 384)
+      self.assertEqual(n_mult(fr), 204)
+      self.assertEqual(n_mult(fv), 220)
+      for F in [fr, fv]:
+        self.checkfunction(F, f, inputs=inputs)
+        self.check_codegen(F, inputs=inputs)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -40,7 +40,7 @@ try:
 except:
   pass
 try:
-  solvers.append(("newton",{},[]))
+  solvers.append(("newton",{},["codegen"]))
 except:
   pass
 
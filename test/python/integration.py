@@ -1013,6 +1013,35 @@ class Integrationtests(casadiTestCase):
       self.assertEqual(len(r),k+1)
 
 
+  def test_codegen(self):
+    x = SX.sym("x",2)
+    z = SX.sym("z")
+    p = SX.sym("p")
+    rx = SX.sym("rx",2)
+    ode = {'x':x, 'p':p, 'ode':vertcat(x[1],-p*x[0]), 'quad':x[0]**2}
+    dae = {'x':x, 'z':z, 'p':p, 'ode':vertcat(x[1],-p*z), 'alg':z-x[0]+0.1*z**3, 'quad':x[0]*z}
+    bwd = {'x':x, 'p':p, 'rx':rx, 'ode':vertcat(x[1],-p*x[0]),
+           'rode':vertcat(-p*rx[1],rx[0]+x[0]), 'rquad':rx[0]*x[1]}
+    inputs = {"x0":[1,0.5], "p":1.3, "rx0":[0.3,-0.1], "rp":0.7}
+
+    for Integrator, opts in [("rk", {}), ("collocation", {"rootfinder": "newton"})]:
+      for name, prob in [("ode", ode), ("dae", dae), ("bwd", bwd)]:
+        if Integrator=="rk" and name=="dae": continue
+        if name=="ode":
+          opts2 = dict(opts, grid=[0,0.5,1.1,2], output_t0=True)
+        else:
+          opts2 = dict(opts, tf=2)
+        intg = integrator("intg_"+name, Integrator, prob, opts2)
+        self.check_codegen(intg, inputs=inputs)
+
+      # Forward and reverse derivatives
+      intg = integrator("intg", Integrator, ode, dict(opts, tf=2))
+      xx = MX.sym("x",2)
+      pp = MX.sym("p")
+      res = intg(x0=xx, p=pp)
+      J = Function("J", [xx, pp], [jacobian(res["xf"], vertcat(xx, pp)), gradient(res["qf"], vertcat(xx, pp))])
+      self.check_codegen(J, inputs=[[1,0.5], 1.3])
+
   @memory_heavy()
   def test_thread_safety(self):
     x = MX.sym('x')
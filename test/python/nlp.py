@@ -1368,6 +1368,90 @@ class NLPtests(casadiTestCase):
       self.checkarray(solver_out["x"],DM([0]),digits=7)
       if "bonmin" not in str(Solver): self.checkarray(solver_out["lam_x"],DM([0]),digits=7)
 
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("qrqp")
+  def test_sqp_gauss_newton(self):
+    x=SX.sym("x",2)
+    r=vertcat(10*(x[1]-x[0]**2),1-x[0])
+    nlp={'x':x, 'f':sumsqr(r), 'g':x[0]+x[1], 'r':r}
+
+    sol = {}
+    for h in ["exact", "gauss-newton"]:
+      solver = nlpsol("mysolver", "sqpmethod", nlp, {"hessian_approximation": h,
+        "qpsol": "qrqp", "qpsol_options": {"print_iter": False}, "print_iteration": False})
+      sol[h] = solver(x0=[-1.2,1],lbg=-10,ubg=1.5)
+      self.assertTrue(solver.stats()["success"])
+    self.checkarray(sol["gauss-newton"]["x"],sol["exact"]["x"],digits=7)
+    self.checkarray(sol["gauss-newton"]["lam_g"],sol["exact"]["lam_g"],digits=7)
+
+    with self.assertInException("residual output 'r'"):
+      nlpsol("mysolver", "sqpmethod", {'x':x, 'f':sumsqr(r)}, {"hessian_approximation": "gauss-newton"})
+
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("qrqp")
+  def test_sqp_partitioned_bfgs(self):
+    N = 5
+    x=SX.sym("x",2*N)
+    f = 0
+    for i in range(N):
+      f += (x[2*i]-1)**2 + (x[2*i+1]-x[2*i]**2)**2
+    nlp={'x':x, 'f':f, 'g':vertcat(sum1(x),x[0]*x[2])}
+
+    opts = {"qpsol": "qrqp", "qpsol_options": {"print_iter": False}, "print_iteration": False}
+    sol = {}
+    for h in ["exact", "limited-memory", "partitioned", "user"]:
+      o = dict(opts)
+      o["hessian_approximation"] = "exact" if h=="exact" else "limited-memory"
+      if h=="partitioned": o["partitioned_bfgs"] = True
+      if h=="user": o["bfgs_blocks"] = [[0,1,2,3]]+[[2*i,2*i+1] for i in range(2,N)]
+      solver = nlpsol("mysolver", "sqpmethod", nlp, o)
+      sol[h] = solver(x0=0.5,lbg=-10,ubg=[4,10])
+      self.assertTrue(solver.stats()["success"])
+    for h in ["limited-memory", "partitioned", "user"]:
+      self.checkarray(sol[h]["x"],sol["exact"]["x"],digits=6)
+    # Only combines with a limited-memory Hessian approximation
+    for h in ["exact", "gauss-newton"]:
+      for o in [{"partitioned_bfgs": True}, {"bfgs_blocks": [[0,1]]}]:
+        o.update(opts)
+        o["hessian_approximation"] = h
+        with self.assertInException("require hessian_approximation 'limited-memory'"):
+          nlpsol("mysolver", "sqpmethod", nlp, o)
+
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("qrqp")
+  def test_sqp_codegen(self):
+    x=SX.sym("x",2)
+    p=SX.sym("p")
+    r=vertcat(p*(x[1]-x[0]**2),1-x[0])
+    nlp={'x':x, 'p':p, 'f':sumsqr(r), 'g':x[0]+x[1], 'r':r}
+
+    for h in ["exact", "gauss-newton", "limited-memory"]:
+      solver = nlpsol("mysolver", "sqpmethod", nlp, {"hessian_approximation": h,
+        "qpsol": "qrqp", "qpsol_options": {"print_iter": False, "print_header": False},
+        "print_iteration": False, "print_header": False, "print_time": False})
+      inputs = {"x0":[-1.2,1],"p":10,"lbx":-inf,"ubx":inf,"lbg":-10,"ubg":1.5}
+      self.check_codegen(solver, inputs, std="c99")
+
+  @requires_nlpsol("sqpmethod")
+  @requires_conic("qrqp")
+  @requires_conic("nlpsol")
+  def test_sqp_jit_no_codegen(self):
+    x=SX.sym("x",2)
+    nlp={'x':x, 'f':sumsqr(x-1), 'g':x[0]+x[1]}
+    quiet = {"print_iteration": False, "print_header": False, "print_time": False}
+    qrqp_options = {"print_iter": False, "print_header": False}
+    # The QP solver, the partitioned BFGS update cannot be code-generated:
+    # only the dependencies are jitted
+    qpsol_options = {"nlpsol": "sqpmethod",
+      "nlpsol_options": dict(quiet, qpsol="qrqp", qpsol_options=qrqp_options)}
+    for o in [{"qpsol": "nlpsol", "qpsol_options": qpsol_options},
+              {"qpsol": "qrqp", "qpsol_options": qrqp_options,
+               "hessian_approximation": "limited-memory", "partitioned_bfgs": True}]:
+      solver = nlpsol("mysolver", "sqpmethod", nlp, dict(quiet, jit=True, compiler="shell", **o))
+      sol = solver(x0=0,lbg=-10,ubg=1)
+      self.assertTrue(solver.stats()["success"])
+      self.checkarray(sol["x"],DM([0.5,0.5]),digits=6)
+
 if __name__ == '__main__':
     unittest.main()
     print(solvers)
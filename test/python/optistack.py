@@ -167,6 +167,50 @@ class OptiStacktests(inherit_from):
       self.checkarray(sol.value(hess_lag),sol.value(tril2symm(sol.opti.debug.casadi_solver.get_function('nlp_hess_l')(opti.x,opti.p,1,opti.lam_g).T)))
 
 
+    def test_values(self):
+      opti = Opti()
+      x = opti.variable(3,1)
+      p = opti.parameter()
+
+      opti.minimize((p*x[1]-x[0]**2)**2)
+      c = opti.subject_to(x[0]+3*x[1]==1)
+
+      opti.solver(nlpsolver,nlpsolver_options)
+      opti.set_value(p, 3)
+
+      sol = opti.solve()
+
+      e = [x[0]*p, sin(x[1]), opti.dual(c)*x[2], x]
+      v = sol.values(e)
+      self.assertEqual(len(v),len(e))
+      for i in range(len(e)):
+        self.checkarray(v[i],sol.value(e[i]))
+      # Cached helpers must honour overrides
+      self.checkarray(sol.values(e,[x==DM([2,0,0])])[0],2*3)
+      self.checkarray(sol.value(e[0],[p==4]),sol.value(x[0])*4)
+      self.checkarray(sol.value(e[0]),sol.value(x[0])*3)
+
+      # Helpers are reused, not reconstructed
+      PerfCounters.reset()
+      PerfCounters.enable()
+      try:
+        sol.values(e)
+        sol.value(e[0])
+        self.assertEqual(PerfCounters.count("function_construct"), 0)
+        # Fresh expressions need a new helper, the cache stays bounded
+        x0 = x[0]
+        x0_value = sol.value(x0)
+        PerfCounters.reset()
+        for i in range(100):
+          self.checkarray(sol.value(x0*p+i), x0_value*3+i)
+        n = PerfCounters.count("function_construct")
+        self.assertTrue(n>0)
+        # The first helpers have been evicted
+        sol.value(e[0])
+        self.assertTrue(PerfCounters.count("function_construct")>n)
+      finally:
+        PerfCounters.enable(False)
+
     def test_warmstart(self):
       opti = Opti()
 